@@ -0,0 +1,206 @@
+#pragma once
+
+// GPU pass timing with GL_TIMESTAMP queries.
+//
+// Every named pass owns one pair of timestamp queries per frame in a small ring.
+// Results are only read back once GL_QUERY_RESULT_AVAILABLE says so, so the CPU
+// never waits on the GPU; a sample that is still not ready when its ring slot comes
+// around again is dropped.
+//
+//   static GpuProfiler gpuProfiler;
+//   gpuProfiler.beginFrame();                      // once per frame, before any scope
+//   { GpuProfiler::Scope s(gpuProfiler, "foliage"); ... draw calls ... }
+//   gpuProfiler.drawImGui();                       // inside an ImGui window
+//   gpuProfiler.release();                         // before the context is destroyed
+//
+// Each pass name should be issued at most once per frame; scopes may nest.
+
+#include <glad/glad.h>
+#include "imgui.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+class GpuProfiler
+{
+public:
+	static const int FRAME_RING = 5;      // frames in flight before a sample is dropped
+	static const int HISTORY = 120;       // samples kept for the rolling average / max
+
+	struct Pass
+	{
+		std::string name;
+		GLuint queries[FRAME_RING][2];
+		bool pending[FRAME_RING];
+		double history[HISTORY];
+		int historyCount;
+		int historyHead;
+		double lastMs;
+		double avgMs;
+		double maxMs;
+	};
+
+	class Scope
+	{
+	public:
+		Scope(GpuProfiler& profiler, const char* name) : m_profiler(profiler), m_index(profiler.begin(name)) {}
+		~Scope() { m_profiler.end(m_index); }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		GpuProfiler& m_profiler;
+		int m_index;
+	};
+
+public:
+	GpuProfiler() {}
+
+	// call while the GL context is still current (a global instance outlives it)
+	void release()
+	{
+		for (Pass& p : m_passes) {
+			glDeleteQueries(FRAME_RING * 2, &p.queries[0][0]);
+		}
+		m_passes.clear();
+	}
+
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+	// collect whatever finished and advance to the next ring slot
+	void beginFrame()
+	{
+		for (Pass& p : m_passes) {
+			for (int slot = 0; slot < FRAME_RING; slot++) {
+				collect(p, slot);
+			}
+		}
+		m_frame = (m_frame + 1) % FRAME_RING;
+		for (Pass& p : m_passes) {
+			p.pending[m_frame] = false; // too old, give up on it
+		}
+	}
+
+	int begin(const char* name)
+	{
+		if (!m_enabled) {
+			return -1;
+		}
+		const int index = findOrAddPass(name);
+		glQueryCounter(m_passes[index].queries[m_frame][0], GL_TIMESTAMP);
+		return index;
+	}
+
+	void end(const int index)
+	{
+		if (index < 0) {
+			return;
+		}
+		Pass& p = m_passes[index];
+		glQueryCounter(p.queries[m_frame][1], GL_TIMESTAMP);
+		p.pending[m_frame] = true;
+	}
+
+	void setEnabled(const bool enabled) { m_enabled = enabled; }
+	bool enabled() const { return m_enabled; }
+	const std::vector<Pass>& passes() const { return m_passes; }
+
+	// most recent collected time of a pass, -1 if it has not completed once yet; it lags the
+	// current frame by up to FRAME_RING frames
+	double lastMs(const char* name) const
+	{
+		for (const Pass& p : m_passes) {
+			if (std::strcmp(p.name.c_str(), name) == 0) {
+				return p.historyCount > 0 ? p.lastMs : -1.0;
+			}
+		}
+		return -1.0;
+	}
+
+	// pass / avg / max / last table, passes in first-seen order
+	void drawImGui()
+	{
+		ImGui::Checkbox("GPU timers", &m_enabled);
+		if (!ImGui::BeginTable("gpu_passes", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+			return;
+		}
+		ImGui::TableSetupColumn("pass");
+		ImGui::TableSetupColumn("avg ms");
+		ImGui::TableSetupColumn("max ms");
+		ImGui::TableSetupColumn("last ms");
+		ImGui::TableHeadersRow();
+
+		double total = 0.0;
+		for (const Pass& p : m_passes) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(p.name.c_str());
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", p.avgMs);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", p.maxMs);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", p.lastMs);
+			total = total + p.avgMs;
+		}
+		ImGui::EndTable();
+		// nested scopes are counted twice here, keep top-level passes disjoint if the sum matters
+		ImGui::Text("sum of avg: %.3f ms", total);
+	}
+
+private:
+	int findOrAddPass(const char* name)
+	{
+		for (size_t i = 0; i < m_passes.size(); i++) {
+			if (std::strcmp(m_passes[i].name.c_str(), name) == 0) {
+				return (int)i;
+			}
+		}
+		Pass p;
+		p.name = name;
+		glGenQueries(FRAME_RING * 2, &p.queries[0][0]);
+		for (int slot = 0; slot < FRAME_RING; slot++) {
+			p.pending[slot] = false;
+		}
+		p.historyCount = 0;
+		p.historyHead = 0;
+		p.lastMs = p.avgMs = p.maxMs = 0.0;
+		m_passes.push_back(p);
+		return (int)m_passes.size() - 1;
+	}
+
+	static void collect(Pass& p, const int slot)
+	{
+		if (!p.pending[slot]) {
+			return;
+		}
+		GLint available = 0;
+		glGetQueryObjectiv(p.queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return;
+		}
+		GLuint64 t0 = 0, t1 = 0;
+		glGetQueryObjectui64v(p.queries[slot][0], GL_QUERY_RESULT, &t0);
+		glGetQueryObjectui64v(p.queries[slot][1], GL_QUERY_RESULT, &t1);
+		p.pending[slot] = false;
+
+		p.lastMs = (t1 > t0) ? (double)(t1 - t0) * 1e-6 : 0.0;
+		p.history[p.historyHead] = p.lastMs;
+		p.historyHead = (p.historyHead + 1) % HISTORY;
+		if (p.historyCount < HISTORY) {
+			p.historyCount = p.historyCount + 1;
+		}
+
+		double sum = 0.0, peak = 0.0;
+		for (int i = 0; i < p.historyCount; i++) {
+			sum = sum + p.history[i];
+			peak = (p.history[i] > peak) ? p.history[i] : peak;
+		}
+		p.avgMs = sum / p.historyCount;
+		p.maxMs = peak;
+	}
+
+private:
+	std::vector<Pass> m_passes;
+	int m_frame = 0;
+	bool m_enabled = true;
+};
@@ -2,9 +2,15 @@
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include "GpuProfiler.h"
+#include "CpuTrace.h"
+#include "FrameCapture.h"
 #include <stdio.h>
 #include <iostream>
 
+static GpuProfiler g_gpuProfiler; // U pass  GPU ɶ
+static FrameCapture g_frameCapture; // v (PBO DPBŪ^A|d GPU)
+
 // ===================== Todo Start ===========================
 using namespace glm;
 using namespace std;
@@ -92,6 +98,7 @@ static const char* fragment_shader_source[] =
 // Main shader pipeline
 void initialize_shader()
 {
+	TRACE_SCOPE("initialize_shader");
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
@@ -186,6 +193,7 @@ GLuint createTextureFromFile(const char* path, bool genMips = true)
 
 void load_goemetry()
 {
+	TRACE_SCOPE("load_goemetry");
 	Load_obj_to_geometry(loadObj("assets/Cube.obj"), Cube);
 	Load_obj_to_geometry(loadObj("assets/Sphere.obj"), Sphere);
 	Load_obj_to_geometry(loadObj("assets/Cylinder.obj"), Cylinder);
@@ -195,6 +203,7 @@ void load_goemetry()
 
 void initialize_robot()
 {
+	TRACE_SCOPE("initialize_robot");
 	float global_scale = 1.0f;
 
 	//torso
@@ -382,6 +391,7 @@ vec3 cubeColor = glm::vec3(1.0f, 0.3f, 0.3f);
 ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 void on_display()
 {
+	TRACE_SCOPE("on_display");
 	glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
 	//glClear(GL_COLOR_BUFFER_BIT);
 
@@ -506,6 +516,22 @@ void on_gui()
 		ImGui::Text("counter = %d", counter);
 
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+		g_gpuProfiler.drawImGui();
+
+		// CPU trace (Chrome trace_event JSON)
+		bool traceEnabled = CpuTrace::enabled();
+		if (ImGui::Checkbox("CPU trace", &traceEnabled))
+		{
+			CpuTrace::setEnabled(traceEnabled);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Dump cpu_trace.json"))
+		{
+			CpuTrace::dump("cpu_trace.json");
+		}
+
+		// Frame capture (PNG sequence / Y4M video)
+		g_frameCapture.drawImGui();
 
 		// ===================== Todo Start =============================
 		ImGui::Separator();
@@ -590,6 +616,8 @@ int main(int, char**)
 	// Main loop
 	while (!glfwWindowShouldClose(window))
 	{
+		TRACE_SCOPE("frame");
+
 		// Poll and handle events (inputs, window resize, etc.)
 		// You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
 		// - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
@@ -609,16 +637,30 @@ int main(int, char**)
 		on_gui();
 
 		// Rendering
-		on_display();
+		g_gpuProfiler.beginFrame();
+		{
+			GpuProfiler::Scope scope(g_gpuProfiler, "robot");
+			on_display();
+		}
 		ImGui::Render();
 		int display_w, display_h;
 		glfwGetFramebufferSize(window, &display_w, &display_h);
 		glViewport(0, 0, display_w, display_h);
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		{
+			GpuProfiler::Scope scope(g_gpuProfiler, "imgui");
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		}
+		g_frameCapture.captureFrame(display_w, display_h);
 		glfwSwapBuffers(window);
 	}
 
 	// Cleanup
+	g_gpuProfiler.release();
+	g_frameCapture.release();
+	if (CpuTrace::enabled())
+	{
+		CpuTrace::dump("cpu_trace.json");
+	}
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
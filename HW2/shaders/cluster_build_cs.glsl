@@ -0,0 +1,58 @@
+#version 460 core
+// 把 view frustum 切成 froxel：x/y 均分螢幕，z 用指數切 (近處切得細)，算出每個 cluster 的 view-space AABB
+// 只有投影矩陣或視窗大小改變時才需要重跑
+layout (local_size_x = 64) in;
+
+struct ClusterAabb {
+    vec4 minPoint;
+    vec4 maxPoint;
+};
+layout (std430, binding = 3) writeonly buffer ClusterAabbs {
+    ClusterAabb clusters[];
+};
+
+uniform uvec3 uClusterGrid;
+uniform mat4 uInvP;
+uniform float uClusterNear;  // 第一片的近端 (= 投影的 near)
+uniform float uClusterFar;   // 指數切片的終點，最後一片再延伸到 uProjFar
+uniform float uProjFar;
+
+// NDC (x, y) 在 near plane 上的 view-space 點
+vec3 ndcToView(vec2 ndc)
+{
+    vec4 p = uInvP * vec4(ndc, -1.0, 1.0);
+    return p.xyz / p.w;
+}
+
+// 從相機出發穿過 p 的射線，和 z = viewZ 平面的交點
+vec3 rayToDepth(vec3 p, float viewZ)
+{
+    return p * (viewZ / p.z);
+}
+
+float sliceDepth(uint slice)
+{
+    if (slice >= uClusterGrid.z) return uProjFar;
+    return uClusterNear * pow(uClusterFar / uClusterNear, float(slice) / float(uClusterGrid.z));
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    uint total = uClusterGrid.x * uClusterGrid.y * uClusterGrid.z;
+    if (index >= total) return;
+
+    uvec3 c = uvec3(index % uClusterGrid.x, (index / uClusterGrid.x) % uClusterGrid.y, index / (uClusterGrid.x * uClusterGrid.y));
+    vec2 ndcMin = vec2(c.xy) / vec2(uClusterGrid.xy) * 2.0 - 1.0;
+    vec2 ndcMax = vec2(c.xy + 1u) / vec2(uClusterGrid.xy) * 2.0 - 1.0;
+    float zNear = -sliceDepth(c.z);
+    float zFar = -sliceDepth(c.z + 1u);
+
+    vec3 pMin = ndcToView(ndcMin);
+    vec3 pMax = ndcToView(ndcMax);
+    vec3 a = rayToDepth(pMin, zNear), b = rayToDepth(pMin, zFar);
+    vec3 d = rayToDepth(pMax, zNear), e = rayToDepth(pMax, zFar);
+
+    clusters[index].minPoint = vec4(min(min(a, b), min(d, e)), 0.0);
+    clusters[index].maxPoint = vec4(max(max(a, b), max(d, e)), 0.0);
+}
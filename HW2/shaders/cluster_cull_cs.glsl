@@ -0,0 +1,71 @@
+#version 460 core
+// 每個 invocation 負責一個 cluster：光源一次 64 個搬進 shared memory，用球 vs AABB 測試
+// 結果寫成固定長度的 slot：clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + i]
+layout (local_size_x = 64) in;
+
+#define MAX_LIGHTS_PER_CLUSTER 128u // 要跟 main.cpp 的 ClusteredLighting::MAX_LIGHTS_PER_CLUSTER 一樣
+
+struct Light {
+    vec4 posRadius;   // world-space 位置, 影響半徑
+    vec4 colorType;   // rgb, w: 0 = point, 1 = spot
+    vec4 spotDirCos;  // world-space 方向, cos(外角)
+};
+layout (std430, binding = 2) readonly buffer Lights {
+    Light lights[];
+};
+
+struct ClusterAabb {
+    vec4 minPoint;
+    vec4 maxPoint;
+};
+layout (std430, binding = 3) readonly buffer ClusterAabbs {
+    ClusterAabb clusters[];
+};
+layout (std430, binding = 4) writeonly buffer ClusterLightCount {
+    uint clusterLightCount[];
+};
+layout (std430, binding = 5) writeonly buffer ClusterLightIndex {
+    uint clusterLightIndex[];
+};
+
+uniform mat4 uV;
+uniform uint uLightCount;
+uniform uint uClusterCount;
+
+shared vec4 sharedLight[64]; // view-space 位置, 半徑
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    bool active = index < uClusterCount;
+    vec3 boxMin = vec3(0.0), boxMax = vec3(0.0);
+    if (active) {
+        boxMin = clusters[index].minPoint.xyz;
+        boxMax = clusters[index].maxPoint.xyz;
+    }
+
+    uint count = 0u;
+    for (uint base = 0u; base < uLightCount; base += 64u) {
+        // 整個 work group 都要走到 barrier，超出範圍的 invocation 也一樣
+        uint li = base + gl_LocalInvocationIndex;
+        if (li < uLightCount) {
+            vec4 pr = lights[li].posRadius;
+            sharedLight[gl_LocalInvocationIndex] = vec4((uV * vec4(pr.xyz, 1.0)).xyz, pr.w);
+        }
+        barrier();
+
+        uint batch = min(64u, uLightCount - base);
+        if (active) {
+            for (uint j = 0u; j < batch && count < MAX_LIGHTS_PER_CLUSTER; ++j) {
+                vec4 l = sharedLight[j];
+                vec3 d = l.xyz - clamp(l.xyz, boxMin, boxMax);
+                if (dot(d, d) <= l.w * l.w) {
+                    clusterLightIndex[index * MAX_LIGHTS_PER_CLUSTER + count] = base + j;
+                    count++;
+                }
+            }
+        }
+        barrier();
+    }
+    if (active) clusterLightCount[index] = count;
+}
@@ -0,0 +1,135 @@
+#version 460 core
+// 【新增】Deferred 的 tiled light accumulation：一個 work group 負責 16x16 pixel
+// 1. 求 tile 內的最小 / 最大深度 (shared atomic)
+// 2. 用 tile 的 view-space AABB 剔除光源，結果放在 shared memory
+// 3. 每個 pixel 從 G-buffer 還原位置 / 法線，只跑 tile 裡的光源，寫回 texColorBuffer
+layout (local_size_x = 16, local_size_y = 16) in;
+
+#define MAX_LIGHTS_PER_TILE 256u
+
+struct Light {
+    vec4 posRadius;   // world-space 位置, 影響半徑
+    vec4 colorType;   // rgb, w: 0 = point, 1 = spot
+    vec4 spotDirCos;  // world-space 方向, cos(外角)
+};
+layout (std430, binding = 2) readonly buffer Lights {
+    Light lights[];
+};
+
+uniform sampler2D uDepth;
+uniform sampler2D uAlbedo;
+uniform sampler2D uNormal;
+layout (rgba8, binding = 0) writeonly uniform image2D uLitImage;
+
+uniform ivec2 uRenderSize; // 動態解析度：只有左下角這塊是這幀畫的
+uniform mat4 uInvP;
+uniform mat4 uV;
+uniform mat4 uInvV;
+uniform uint uLightCount;
+uniform bool uLocalLights = true;
+uniform bool uShowTileHeat = false;
+// 跟 scene_fs.glsl 一樣的平行光
+uniform vec3 uLightDir = normalize(vec3(-0.5, -1.0, -0.3));
+uniform float uAmbient = 0.25;
+
+shared uint tileMinDepth;
+shared uint tileMaxDepth;
+shared uint tileLightCount;
+shared uint tileLights[MAX_LIGHTS_PER_TILE];
+
+vec3 viewPosFromDepth(vec2 uv, float depth)
+{
+    vec4 p = uInvP * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return p.xyz / p.w;
+}
+
+vec3 localLight(Light light, vec3 P, vec3 N)
+{
+    vec3 toLight = light.posRadius.xyz - P;
+    float dist2 = dot(toLight, toLight);
+    float radius = light.posRadius.w;
+    if (dist2 >= radius * radius) return vec3(0.0);
+
+    vec3 L = toLight * inversesqrt(max(dist2, 1e-8));
+    float r4 = dist2 * dist2 / (radius * radius * radius * radius);
+    float window = clamp(1.0 - r4, 0.0, 1.0);
+    float attenuation = window * window / (dist2 + 1.0);
+    if (light.colorType.w > 0.5) {
+        float cosAngle = dot(-L, light.spotDirCos.xyz);
+        attenuation *= smoothstep(light.spotDirCos.w, mix(light.spotDirCos.w, 1.0, 0.2), cosAngle);
+    }
+    return light.colorType.rgb * max(dot(N, L), 0.0) * attenuation;
+}
+
+void main()
+{
+    ivec2 size = uRenderSize;
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    bool inside = pixel.x < size.x && pixel.y < size.y;
+    float depth = inside ? texelFetch(uDepth, pixel, 0).r : 1.0;
+
+    if (gl_LocalInvocationIndex == 0u) {
+        tileMinDepth = 0xFFFFFFFFu;
+        tileMaxDepth = 0u;
+        tileLightCount = 0u;
+    }
+    barrier();
+    // [0, 1) 的正 float 用 bit pattern 比大小結果一樣
+    if (depth < 1.0) {
+        atomicMin(tileMinDepth, floatBitsToUint(depth));
+        atomicMax(tileMaxDepth, floatBitsToUint(depth));
+    }
+    barrier();
+
+    if (uLocalLights && tileMinDepth <= tileMaxDepth) {
+        // tile 四個角在最小 / 最大深度的 8 個點，取 AABB
+        vec2 uvMin = vec2(gl_WorkGroupID.xy * gl_WorkGroupSize.xy) / vec2(size);
+        vec2 uvMax = vec2((gl_WorkGroupID.xy + 1u) * gl_WorkGroupSize.xy) / vec2(size);
+        float dMin = uintBitsToFloat(tileMinDepth), dMax = uintBitsToFloat(tileMaxDepth);
+        vec3 boxMin = vec3(1e30), boxMax = vec3(-1e30);
+        for (int c = 0; c < 8; ++c) {
+            vec2 uv = vec2((c & 1) != 0 ? uvMax.x : uvMin.x, (c & 2) != 0 ? uvMax.y : uvMin.y);
+            vec3 p = viewPosFromDepth(uv, (c & 4) != 0 ? dMax : dMin);
+            boxMin = min(boxMin, p);
+            boxMax = max(boxMax, p);
+        }
+        for (uint i = gl_LocalInvocationIndex; i < uLightCount; i += gl_WorkGroupSize.x * gl_WorkGroupSize.y) {
+            vec4 pr = lights[i].posRadius;
+            vec3 center = (uV * vec4(pr.xyz, 1.0)).xyz;
+            vec3 d = center - clamp(center, boxMin, boxMax);
+            if (dot(d, d) <= pr.w * pr.w) {
+                uint slot = atomicAdd(tileLightCount, 1u);
+                if (slot < MAX_LIGHTS_PER_TILE) tileLights[slot] = i;
+            }
+        }
+    }
+    barrier();
+
+    if (!inside) return;
+    vec3 albedo = texelFetch(uAlbedo, pixel, 0).rgb;
+    if (depth >= 1.0) {
+        // 沒有幾何的地方 albedo 是清除色，直接輸出
+        imageStore(uLitImage, pixel, vec4(albedo, 1.0));
+        return;
+    }
+
+    vec3 N = normalize(texelFetch(uNormal, pixel, 0).xyz);
+    vec3 viewPos = viewPosFromDepth((vec2(pixel) + 0.5) / vec2(size), depth);
+    vec3 worldPos = (uInvV * vec4(viewPos, 1.0)).xyz;
+
+    float diff = max(dot(N, -uLightDir), 0.0);
+    vec3 color = albedo * (uAmbient + (1.0 - uAmbient) * diff);
+    uint count = min(tileLightCount, MAX_LIGHTS_PER_TILE);
+    vec3 local = vec3(0.0);
+    for (uint i = 0u; i < count; ++i) {
+        local += localLight(lights[tileLights[i]], worldPos, N);
+    }
+    color += albedo * local;
+    if (uShowTileHeat) {
+        // 每個 tile 的光源數：藍 (0) -> 綠 -> 紅 (>= 32)，跟 scene_fs 的 cluster heatmap 一樣
+        float t = clamp(float(count) / 32.0, 0.0, 1.0);
+        vec3 heat = t < 0.5 ? mix(vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 0.0), t * 2.0) : mix(vec3(0.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), t * 2.0 - 1.0);
+        color = mix(color, heat, 0.5);
+    }
+    imageStore(uLitImage, pixel, vec4(color, 1.0));
+}
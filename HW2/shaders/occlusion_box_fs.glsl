@@ -0,0 +1,5 @@
+#version 460 core
+// occlusion query 只看有沒有 sample 通過深度測試，顏色不寫
+void main()
+{
+}
@@ -0,0 +1,12 @@
+#version 460 core
+layout (location = 0) in vec3 vPos; // 單位立方體 [0,1]^3
+
+uniform mat4 uVP;
+uniform vec3 uBoxMin; // world AABB
+uniform vec3 uBoxMax;
+
+void main()
+{
+    vec3 worldPos = mix(uBoxMin, uBoxMax, vPos);
+    gl_Position = uVP * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,23 @@
+// 【新增】所有後製 shader 共用 (buildProgramFromFiles 會把 #include 展開)
+//
+// 動態解析度：場景只畫在 texColorBuffer 左下角 uUVScale 的範圍，後製一律用螢幕 uv (0..1)，
+// 取樣時再換算並夾在已經畫過的範圍內，放大就在這個 pass 裡完成。
+uniform vec2 uUVScale = vec2(1.0);
+uniform float uSharpness = 0.0; // 0 = 不銳化；解析度降低時由 main.cpp 調高，補回放大的模糊
+
+vec4 sampleScene(sampler2D tex, vec2 uv)
+{
+    vec2 halfTexel = 0.5 / vec2(textureSize(tex, 0));
+    return texture(tex, clamp(uv * uUVScale, halfTexel, uUVScale - halfTexel));
+}
+
+// 放大 + 十字 5-tap unsharp mask，跟效果算在同一個 pass，不另外多一個全螢幕 pass
+vec4 sampleSceneSharpened(sampler2D tex, vec2 uv)
+{
+    vec4 c = sampleScene(tex, uv);
+    if (uSharpness <= 0.0) return c;
+    vec2 d = 1.0 / (vec2(textureSize(tex, 0)) * uUVScale); // 場景一個 texel 在螢幕 uv 的大小
+    vec3 n = sampleScene(tex, uv + vec2(d.x, 0.0)).rgb + sampleScene(tex, uv - vec2(d.x, 0.0)).rgb
+           + sampleScene(tex, uv + vec2(0.0, d.y)).rgb + sampleScene(tex, uv - vec2(0.0, d.y)).rgb;
+    return vec4(max(c.rgb + (c.rgb - n * 0.25) * uSharpness, vec3(0.0)), c.a);
+}
@@ -0,0 +1,83 @@
+#version 460 core
+// 【新增】Image abstraction 的 compute 版本 (效果跟 pp_fs_abstraction.glsl 一樣)
+// fragment 版每個 pixel 要 9 次 blur + 8 次 Sobel 取樣，鄰居之間大量重複；
+// 這裡每個 work group 先把 16x16 的 tile 加上四周 APRON 讀進 shared memory 一次，blur / Sobel 都從裡面拿。
+#include "pp_common.glsl"
+layout (local_size_x = 16, local_size_y = 16) in;
+
+#ifndef OUTPUT_FORMAT
+#define OUTPUT_FORMAT rgba8
+#endif
+layout (OUTPUT_FORMAT, binding = 0) uniform writeonly image2D uOutput;
+
+uniform sampler2D uScreenTexture;
+uniform ivec2 uOutputSize;
+
+// 【新增】temporal：用 glDispatchComputeIndirect 跑 pp_cs_temporal_reproject.glsl 排好的 tile 清單，一個 work group 一塊
+#include "pp_temporal.glsl"
+layout (std430, binding = 6) readonly buffer TemporalTiles { uint temporalTiles[]; };
+
+// Comparison Uniforms
+uniform bool uEnableComparison;
+uniform float uBarPosition;
+uniform float uBarWidth = 0.005;
+
+// --- Abstraction Parameters (跟 pp_fs_abstraction.glsl 一樣：階數用 #define，連續的用 uniform) ---
+uniform float uAbstractionBlurSize = 1.0 / 512.0; // 跟 fragment 版一樣是 uv 單位，換成 pixel 後四捨五入
+#ifndef ABSTRACTION_LEVELS
+#define ABSTRACTION_LEVELS 8.0
+#endif
+const float numColorLevels = ABSTRACTION_LEVELS;
+uniform float uAbstractionEdgeThreshold = 0.2;
+
+const int TILE = 16;
+// 最大的取樣距離 (pixel，跟 main.cpp 的 ABSTRACTION_CS_APRON 一樣)。
+// round(uAbstractionBlurSize * 寬高) 超過的話 main.cpp 會改走 fragment 版；下面的 clamp 只是保險
+const int APRON = 8;
+const int TILE_W = TILE + 2 * APRON;
+shared vec3 sTile[TILE_W * TILE_W];
+
+vec3 tileAt(ivec2 local) {
+    return sTile[(local.y + APRON) * TILE_W + local.x + APRON];
+}
+
+void main() {
+    ivec2 tile = uTemporalPeriod > 1 ? temporalUnpackTile(temporalTiles[gl_WorkGroupID.x]) : ivec2(gl_WorkGroupID.xy);
+    ivec2 groupOrigin = tile * TILE;
+    ivec2 lid = ivec2(gl_LocalInvocationID.xy);
+    vec2 invSize = 1.0 / vec2(uOutputSize);
+
+    // 1. 整個 tile + apron 一起讀，每個 thread 讀 TILE_W^2 / 256 (= 4) 個；動態解析度的放大也在這裡
+    for (int i = int(gl_LocalInvocationIndex); i < TILE_W * TILE_W; i += TILE * TILE) {
+        ivec2 p = groupOrigin - APRON + ivec2(i % TILE_W, i / TILE_W);
+        sTile[i] = sampleScene(uScreenTexture, (vec2(p) + 0.5) * invSize).rgb;
+    }
+    barrier();
+
+    ivec2 pixel = groupOrigin + lid;
+    if (any(greaterThanEqual(pixel, uOutputSize))) return;
+    ivec2 o = clamp(ivec2(round(uAbstractionBlurSize * vec2(uOutputSize))), ivec2(1), ivec2(APRON));
+
+    // 2. Blur + Quantization
+    vec3 tl = tileAt(lid + ivec2(-o.x, -o.y)), tm = tileAt(lid + ivec2(0, -o.y)), tr = tileAt(lid + ivec2(o.x, -o.y));
+    vec3 ml = tileAt(lid + ivec2(-o.x, 0)),    mm = tileAt(lid),                 mr = tileAt(lid + ivec2(o.x, 0));
+    vec3 bl = tileAt(lid + ivec2(-o.x, o.y)),  bm = tileAt(lid + ivec2(0, o.y)),  br = tileAt(lid + ivec2(o.x, o.y));
+    vec3 blurred = (tl + tm + tr + ml + mm + mr + bl + bm + br) / 9.0;
+    vec3 quantizedColor = floor(blurred * numColorLevels) / numColorLevels;
+
+    // 3. Sobel (同一組鄰居)
+    vec3 gx = -tl - 2.0*ml - bl + tr + 2.0*mr + br;
+    vec3 gy = -tl - 2.0*tm - tr + bl + 2.0*bm + br;
+    float edgeFactor = smoothstep(0.0, uAbstractionEdgeThreshold, length(gx) + length(gy));
+    vec4 finalColor = vec4(mix(quantizedColor, vec3(0.0), edgeFactor), 1.0);
+
+    // Apply Comparison Bar logic
+    vec2 uv = (vec2(pixel) + 0.5) * invSize;
+    if (uEnableComparison && uv.x < uBarPosition) {
+        finalColor = sampleSceneSharpened(uScreenTexture, uv);
+    }
+    if (uEnableComparison && abs(uv.x - uBarPosition) < uBarWidth * 0.5) {
+        finalColor = vec4(1.0, 0.0, 0.0, 1.0); // Red bar
+    }
+    imageStore(uOutput, pixel, finalColor);
+}
@@ -0,0 +1,79 @@
+#version 460 core
+// 【新增】Temporal amortization 的第一步：每個 temporal pass 先跑一次，一個 work group 一塊 16x16 tile
+// 1. 每個 pixel 存這幀的深度 (這一段自己的 r32f 歷史)，下一幀判斷 disocclusion 用，不用整張複製 depth-stencil
+// 2. 這幀沒輪到的 tile 用 on_display 的相機矩陣從上一幀這一段的輸出 reproject 過來
+// 3. 輪到的、歷史不能用的、或有任何 pixel reproject 失敗 (出畫面、disocclusion) 的 tile 加進清單，
+//    效果只跑清單上的 tile (glDrawArraysIndirect / glDispatchComputeIndirect)，失敗的 pixel 整塊 tile 重算
+#include "pp_temporal.glsl"
+layout (local_size_x = 16, local_size_y = 16) in; // TEMPORAL_TILE
+
+#ifndef OUTPUT_FORMAT
+#define OUTPUT_FORMAT rgba8
+#endif
+layout (OUTPUT_FORMAT, binding = 0) uniform writeonly image2D uOutput;
+layout (r32f, binding = 1) uniform writeonly image2D uDepthOutput;
+layout (std430, binding = 6) writeonly buffer TemporalTiles { uint temporalTiles[]; };
+layout (std430, binding = 7) buffer TemporalIndirect {
+    uint drawCount, drawInstances, drawFirst, drawBaseInstance; // DrawArraysIndirectCommand
+    uint dispatchX, dispatchY, dispatchZ;                        // DispatchIndirectCommand
+};
+
+uniform sampler2D uHistory;   // 上一幀這一段的輸出
+uniform sampler2D uPrevDepth; // 上一幀這裡存的深度 (r32f，跟輸出一樣大)
+uniform sampler2D uDepth;     // 這幀的深度 (fbo 的 depth texture)
+uniform vec2 uHistoryUVScale = vec2(1.0);
+uniform vec2 uDepthUVScale = vec2(1.0); // 動態解析度：深度只有左下角有畫
+uniform mat4 uInvViewProj;
+uniform mat4 uPrevViewProj;
+uniform mat4 uPrevInvViewProj;
+uniform vec3 uCameraPos;
+uniform ivec2 uOutputSize;
+uniform bool uHistoryValid = false;
+uniform int uRecomputeBelowX = 0; // comparison bar 左邊 (pixel) 每幀都算
+
+shared bool sRecompute;
+
+vec3 temporalWorldPos(mat4 invViewProj, vec2 uv, float depth) {
+    vec4 p = invViewProj * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return p.xyz / p.w;
+}
+
+void main() {
+    ivec2 tile = ivec2(gl_WorkGroupID.xy);
+    ivec2 pixel = tile * TEMPORAL_TILE + ivec2(gl_LocalInvocationID.xy);
+    if (gl_LocalInvocationIndex == 0)
+        sRecompute = !uHistoryValid || temporalDue(tile) || tile.x * TEMPORAL_TILE < uRecomputeBelowX;
+    barrier();
+
+    bool inside = all(lessThan(pixel, uOutputSize));
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(uOutputSize);
+    float depth = texture(uDepth, uv * uDepthUVScale).r;
+    if (inside) imageStore(uDepthOutput, pixel, vec4(depth));
+
+    if (inside && !sRecompute) {
+        bool ok = false;
+        vec3 world = temporalWorldPos(uInvViewProj, uv, depth);
+        vec4 prevClip = uPrevViewProj * vec4(world, 1.0);
+        if (prevClip.w > 0.0) {
+            vec2 prevUV = prevClip.xy / prevClip.w * 0.5 + 0.5;
+            if (all(greaterThanEqual(prevUV, vec2(0.0))) && all(lessThanEqual(prevUV, vec2(1.0)))) {
+                // disocclusion：上一幀在那個位置看到的不是同一個點 (距離跟著離相機的遠近放寬)
+                ivec2 prevPixel = min(ivec2(prevUV * vec2(uOutputSize)), uOutputSize - 1);
+                vec3 prevWorld = temporalWorldPos(uPrevInvViewProj, prevUV, texelFetch(uPrevDepth, prevPixel, 0).r);
+                if (distance(prevWorld, world) <= 0.02 * distance(world, uCameraPos)) {
+                    imageStore(uOutput, pixel, texture(uHistory, prevUV * uHistoryUVScale));
+                    ok = true;
+                }
+            }
+        }
+        if (!ok) sRecompute = true; // 這塊 tile 整塊交給效果重算 (蓋掉上面已經 reproject 的 pixel)
+    }
+    memoryBarrierShared();
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0 && sRecompute) {
+        uint slot = atomicAdd(drawInstances, 1u);
+        atomicAdd(dispatchX, 1u);
+        temporalTiles[slot] = uint(tile.x) | (uint(tile.y) << 16);
+    }
+}
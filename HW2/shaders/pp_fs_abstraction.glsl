@@ -1,4 +1,5 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
@@ -9,43 +10,50 @@ uniform bool uEnableComparison;
 uniform float uBarPosition;
 uniform float uBarWidth = 0.005;
 
-// --- Abstraction Parameters (Hardcoded) ---
-const float blurSize = 1.0 / 512.0; // Adjust blur radius based on texture size
-const float numColorLevels = 8.0;   // Number of quantization levels
-const float edgeThreshold = 0.2;    // Edge detection sensitivity
+// --- Abstraction Parameters ---
+// 【修改】main.cpp 可以用 #define 換掉階數 (GUI 調整時重編一份，見 PostEffectParam)；
+// 模糊大小和邊緣門檻是連續的 slider，用 uniform，拖動時不會一直重編
+uniform float uAbstractionBlurSize = 1.0 / 512.0;    // Adjust blur radius based on texture size
+#ifndef ABSTRACTION_LEVELS
+#define ABSTRACTION_LEVELS 8.0
+#endif
+const float numColorLevels = ABSTRACTION_LEVELS;     // Number of quantization levels
+uniform float uAbstractionEdgeThreshold = 0.2;       // Edge detection sensitivity
 
 // Simple Box Blur
 vec4 applyBlur(sampler2D tex, vec2 uv) {
+    float blurSize = uAbstractionBlurSize;
     vec4 sum = vec4(0.0);
-    sum += texture(tex, uv + vec2(-blurSize, -blurSize));
-    sum += texture(tex, uv + vec2( 0.0,     -blurSize));
-    sum += texture(tex, uv + vec2( blurSize, -blurSize));
-    sum += texture(tex, uv + vec2(-blurSize,  0.0));
-    sum += texture(tex, uv + vec2( 0.0,      0.0));
-    sum += texture(tex, uv + vec2( blurSize,  0.0));
-    sum += texture(tex, uv + vec2(-blurSize,  blurSize));
-    sum += texture(tex, uv + vec2( 0.0,      blurSize));
-    sum += texture(tex, uv + vec2( blurSize,  blurSize));
+    sum += sampleScene(tex, uv + vec2(-blurSize, -blurSize));
+    sum += sampleScene(tex, uv + vec2( 0.0,     -blurSize));
+    sum += sampleScene(tex, uv + vec2( blurSize, -blurSize));
+    sum += sampleScene(tex, uv + vec2(-blurSize,  0.0));
+    sum += sampleScene(tex, uv + vec2( 0.0,      0.0));
+    sum += sampleScene(tex, uv + vec2( blurSize,  0.0));
+    sum += sampleScene(tex, uv + vec2(-blurSize,  blurSize));
+    sum += sampleScene(tex, uv + vec2( 0.0,      blurSize));
+    sum += sampleScene(tex, uv + vec2( blurSize,  blurSize));
     return sum / 9.0;
 }
 
 // Sobel Edge Detection (approximates DoG effect [cite: 78])
 float applyEdgeDetection(sampler2D tex, vec2 uv) {
+    float blurSize = uAbstractionBlurSize;
     float dx = blurSize; // Use blurSize for pixel offset
     float dy = blurSize;
-    vec3 tl = texture(tex, uv + vec2(-dx, -dy)).rgb;
-    vec3 tm = texture(tex, uv + vec2(0.0,-dy)).rgb;
-    vec3 tr = texture(tex, uv + vec2( dx, -dy)).rgb;
-    vec3 ml = texture(tex, uv + vec2(-dx, 0.0)).rgb;
-    vec3 mr = texture(tex, uv + vec2( dx, 0.0)).rgb;
-    vec3 bl = texture(tex, uv + vec2(-dx,  dy)).rgb;
-    vec3 bm = texture(tex, uv + vec2(0.0,  dy)).rgb;
-    vec3 br = texture(tex, uv + vec2( dx,  dy)).rgb;
+    vec3 tl = sampleScene(tex, uv + vec2(-dx, -dy)).rgb;
+    vec3 tm = sampleScene(tex, uv + vec2(0.0,-dy)).rgb;
+    vec3 tr = sampleScene(tex, uv + vec2( dx, -dy)).rgb;
+    vec3 ml = sampleScene(tex, uv + vec2(-dx, 0.0)).rgb;
+    vec3 mr = sampleScene(tex, uv + vec2( dx, 0.0)).rgb;
+    vec3 bl = sampleScene(tex, uv + vec2(-dx,  dy)).rgb;
+    vec3 bm = sampleScene(tex, uv + vec2(0.0,  dy)).rgb;
+    vec3 br = sampleScene(tex, uv + vec2( dx,  dy)).rgb;
 
     vec3 gx = -tl - 2.0*ml - bl + tr + 2.0*mr + br;
     vec3 gy = -tl - 2.0*tm - tr + bl + 2.0*bm + br;
     float edge = length(gx) + length(gy);
-    return smoothstep(0.0, edgeThreshold, edge); // Make edges black
+    return smoothstep(0.0, uAbstractionEdgeThreshold, edge); // Make edges black
 }
 
 // Color Quantization [cite: 77]
@@ -54,7 +62,7 @@ vec3 applyQuantization(vec3 color) {
 }
 
 void main() {
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // Calculate effect color: Blur + Quantization + Edge Detection [cite: 76, 79]
     vec4 blurredColor = applyBlur(uScreenTexture, vUV);
@@ -1,4 +1,5 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
@@ -9,57 +10,34 @@ uniform bool uEnableComparison;
 uniform float uBarPosition;
 uniform float uBarWidth = 0.005;
 
-// --- Bloom Parameters (Hardcoded) ---
-const float bloomThreshold = 0.75; // 亮度閾值
-const float bloomIntensity = 3.5; // 光暈強度 (可調高)
-const int blurRadius = 7; // 模糊採樣半徑 (例如 7x7 範圍)
-
-// --- 高斯模糊權重 (近似值，可以預先計算好) ---
-// 這裡用一個簡單的線性衰減代替，效果接近但計算簡單
-// const float gaussianWeight[blurRadius + 1] = float[]( ... ); // 精確高斯權重
-
-// Extract bright parts (Thresholding) - 使用 smoothstep 平滑過渡
-vec4 extractBright(vec4 color) {
-    float brightness = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722));
-    float factor = smoothstep(bloomThreshold - 0.1, bloomThreshold + 0.15, brightness); // 稍微放寬範圍
-    return color * factor;
-}
-
-// 近似高斯模糊 (合併水平和垂直)
-vec4 applyApproxGaussian(sampler2D tex, vec2 uv) {
-    vec2 texelSize = 1.0 / textureSize(tex, 0); // 單個像素在 UV 中的大小
-    vec4 result = vec4(0.0);
-    float totalWeight = 0.0;
-
-    for (int x = -blurRadius; x <= blurRadius; ++x) {
-        for (int y = -blurRadius; y <= blurRadius; ++y) {
-            // 計算距離中心的權重 (簡單線性衰減)
-            float dist = sqrt(float(x*x + y*y));
-            float weight = max(0.0, 1.0 - dist / float(blurRadius)); // 距離越遠權重越低
-            
-            // 計算採樣座標
-            vec2 offset = vec2(float(x), float(y)) * texelSize;
-            // 只對亮部進行採樣和加權
-            result += extractBright(texture(tex, uv + offset)) * weight;
-            totalWeight += weight;
-        }
-    }
-
-    if (totalWeight > 0.0) {
-        return result / totalWeight; // 平均權重
-    } else {
-        return vec4(0.0);
-    }
-}
+// 【修改】原本在這裡對每個 pixel 做 15x15 = 225 次取樣 (每次都取亮部)。
+// 現在改成多個 pass：pp_fs_bloom_prefilter 取亮部 + 縮一半，pp_fs_bloom_downsample / upsample
+// 做 mip chain 模糊，這個 pass 只負責把結果加回原圖。
+uniform sampler2D uBloomTexture;        // mip chain 最上層 (半解析度)
+uniform vec2 uBloomUVScale = vec2(1.0); // bloom target 有用到的範圍 (pool 借來的 target 比較大)
 
+// --- Bloom Parameters ---
+uniform float uBloomIntensity = 3.5; // 光暈強度 (可調高)
 
 void main() {
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // Calculate effect color: Original + Blurred Bright Parts
-    // 【修改】使用新的模糊函數
-    vec4 blurredBright = applyApproxGaussian(uScreenTexture, vUV); 
-    vec4 effectColor = originalColor + blurredBright * bloomIntensity;
+    // 【修改】改讀 mip chain 模糊好的亮部，再做一次 3x3 tent (間隔 1.5 texel) 把半解析度的方塊感抹掉，
+    // 補回舊版 7 px 線性衰減的尾巴
+    vec2 texel = 1.0 / vec2(textureSize(uBloomTexture, 0));
+    vec2 halfTexel = 0.5 * texel;
+    vec2 uv = vUV * uBloomUVScale;
+    vec4 blurredBright = vec4(0.0);
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            float weight = float((2 - abs(x)) * (2 - abs(y)));
+            vec2 tapUV = clamp(uv + vec2(x, y) * 1.5 * texel, halfTexel, uBloomUVScale - halfTexel);
+            blurredBright += texture(uBloomTexture, tapUV) * weight;
+        }
+    }
+    blurredBright /= 16.0;
+    vec4 effectColor = originalColor + blurredBright * uBloomIntensity;
 
     // Apply Comparison Bar logic
     vec4 finalColor;
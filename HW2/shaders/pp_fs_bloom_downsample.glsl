@@ -0,0 +1,17 @@
+#version 410 core
+#include "pp_common.glsl"
+// 【新增】Bloom mip chain 往下：dual filter downsample，每一層是上一層的一半
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D uScreenTexture; // 上一層 (比較大的那層)
+
+void main() {
+    vec2 d = 0.5 / (vec2(textureSize(uScreenTexture, 0)) * uUVScale); // 上一層半個 texel
+    vec4 sum = sampleScene(uScreenTexture, vUV) * 4.0;
+    sum += sampleScene(uScreenTexture, vUV + vec2(-d.x, -d.y));
+    sum += sampleScene(uScreenTexture, vUV + vec2( d.x, -d.y));
+    sum += sampleScene(uScreenTexture, vUV + vec2(-d.x,  d.y));
+    sum += sampleScene(uScreenTexture, vUV + vec2( d.x,  d.y));
+    FragColor = sum / 8.0;
+}
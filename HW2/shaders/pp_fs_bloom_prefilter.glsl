@@ -0,0 +1,27 @@
+#version 410 core
+#include "pp_common.glsl"
+// 【新增】Bloom 第一步：取亮部 + 縮到一半解析度 (畫進 pool 借來的 target，viewport = 半解析度)
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D uScreenTexture;
+
+const float bloomThreshold = 0.75; // 亮度閾值 (跟原本單 pass 版本一樣)
+
+vec4 extractBright(vec4 color) {
+    float brightness = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722));
+    float factor = smoothstep(bloomThreshold - 0.1, bloomThreshold + 0.15, brightness);
+    return color * factor;
+}
+
+void main() {
+    // 5 個 bilinear tap (中間 + 四個斜角) 等於平均了 4x4 個原始 pixel，
+    // 每個 tap 先取亮部再平均，順序跟原本一樣，不會因為先平均而把小亮點抹掉
+    vec2 d = 1.0 / (vec2(textureSize(uScreenTexture, 0)) * uUVScale); // 輸入一個 texel 在螢幕 uv 的大小
+    vec4 sum = extractBright(sampleScene(uScreenTexture, vUV)) * 4.0;
+    sum += extractBright(sampleScene(uScreenTexture, vUV + vec2(-d.x, -d.y)));
+    sum += extractBright(sampleScene(uScreenTexture, vUV + vec2( d.x, -d.y)));
+    sum += extractBright(sampleScene(uScreenTexture, vUV + vec2(-d.x,  d.y)));
+    sum += extractBright(sampleScene(uScreenTexture, vUV + vec2( d.x,  d.y)));
+    FragColor = sum / 8.0;
+}
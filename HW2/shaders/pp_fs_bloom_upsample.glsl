@@ -0,0 +1,20 @@
+#version 410 core
+#include "pp_common.glsl"
+// 【新增】Bloom mip chain 往上：dual filter upsample (tent)，main.cpp 用 GL_ONE, GL_ONE 加回比較大的那層
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D uScreenTexture; // 下一層 (比較小的那層)
+
+void main() {
+    vec2 d = 1.0 / (vec2(textureSize(uScreenTexture, 0)) * uUVScale); // 下一層一個 texel
+    vec4 sum = sampleScene(uScreenTexture, vUV + vec2(-d.x * 2.0, 0.0));
+    sum += sampleScene(uScreenTexture, vUV + vec2( d.x * 2.0, 0.0));
+    sum += sampleScene(uScreenTexture, vUV + vec2(0.0, -d.y * 2.0));
+    sum += sampleScene(uScreenTexture, vUV + vec2(0.0,  d.y * 2.0));
+    sum += sampleScene(uScreenTexture, vUV + vec2(-d.x, -d.y)) * 2.0;
+    sum += sampleScene(uScreenTexture, vUV + vec2( d.x, -d.y)) * 2.0;
+    sum += sampleScene(uScreenTexture, vUV + vec2(-d.x,  d.y)) * 2.0;
+    sum += sampleScene(uScreenTexture, vUV + vec2( d.x,  d.y)) * 2.0;
+    FragColor = sum / 12.0;
+}
@@ -1,4 +1,5 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
@@ -27,7 +28,7 @@ vec2 calculateSineWaveUV(vec2 uv, float time, float power1, float power2) {
 
 void main() {
     // 1. 計算原始顏色
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // 2. 根據 uCompareEffectType 計算效果顏色
     vec4 effectColor = originalColor; // 預設為原始顏色
@@ -38,13 +39,13 @@ void main() {
         float pixelH = uPixelSize / texSize.y;
         float newX = floor(vUV.x / pixelW) * pixelW + 0.5 * pixelW;
         float newY = floor(vUV.y / pixelH) * pixelH + 0.5 * pixelH;
-        effectColor = texture(uScreenTexture, vec2(newX, newY));
+        effectColor = sampleScene(uScreenTexture, vec2(newX, newY));
     } 
     else if (uCompareEffectType == 6) { // Sine Wave
         vec2 sineUV = calculateSineWaveUV(vUV, uTime, uSinePower1, uSinePower2);
         // 確保 UV 不會超出範圍 (sine 可能會把它推出去)
         if (sineUV.x >= 0.0 && sineUV.x <= 1.0 && sineUV.y >= 0.0 && sineUV.y <= 1.0) {
-             effectColor = texture(uScreenTexture, sineUV);
+             effectColor = sampleScene(uScreenTexture, sineUV);
         } else {
              effectColor = vec4(0.0, 0.0, 0.0, 1.0); // 超出範圍顯示黑色
         }
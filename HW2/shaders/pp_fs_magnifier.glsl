@@ -1,13 +1,12 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
 uniform sampler2D uScreenTexture;
 
 // --- Magnifier Uniforms ---
-uniform vec2 uMousePos;   // Mouse position (0.0 to 1.0, Y flipped)
-uniform float uRadius = 0.2; // Magnifier radius (normalized)
-uniform float uZoom = 2.0;   // Zoom factor
+#include "pp_fx_magnifier.glsl"
 
 // --- Comparison Uniforms ---
 uniform bool uEnableComparison;
@@ -15,24 +14,15 @@ uniform float uBarPosition;
 uniform float uBarWidth = 0.005;
 
 void main() {
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
     vec4 effectColor = originalColor; // Default to original
 
-    // Calculate distance from mouse
-    float dist = distance(vUV, uMousePos);
-
-    // If inside the radius, calculate zoomed UV
-    if (dist < uRadius) {
-        vec2 relativeUV = (vUV - uMousePos) / uRadius; 
-        relativeUV /= uZoom;
-        vec2 zoomedUV = uMousePos + relativeUV * uRadius;
-
-        // Sample texture with zoomed UV (clamp to avoid sampling outside)
-        if (zoomedUV.x >= 0.0 && zoomedUV.x <= 1.0 && zoomedUV.y >= 0.0 && zoomedUV.y <= 1.0) {
-             effectColor = texture(uScreenTexture, zoomedUV);
-        } else {
-             effectColor = vec4(0.0); // Black outside texture bounds
-        }
+    // 【修改】uv 映射移到 pp_fx_magnifier.glsl
+    vec2 zoomedUV = vUV;
+    if (!fxMagnifier(zoomedUV)) {
+        effectColor = vec4(0.0); // Black outside texture bounds
+    } else if (zoomedUV != vUV) {
+        effectColor = sampleScene(uScreenTexture, zoomedUV);
     }
 
     // Apply Comparison Bar logic
@@ -1,4 +1,5 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
@@ -11,7 +12,7 @@ uniform float uBarWidth = 0.005; // Optional: for drawing the bar
 
 void main() {
     // 1. Get original color
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // 2. Calculate "effect" color (for passthrough, it's just the original)
     vec4 effectColor = originalColor; 
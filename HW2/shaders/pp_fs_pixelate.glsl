@@ -1,9 +1,10 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
 uniform sampler2D uScreenTexture;
-uniform float uPixelSize = 64.0;
+#include "pp_fx_pixelate.glsl"
 
 // --- Add Comparison Uniforms ---
 uniform bool uEnableComparison;
@@ -12,15 +13,13 @@ uniform float uBarWidth = 0.005; // Optional
 
 void main() {
     // 1. Get original color
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // 2. Calculate effect color (Pixelization logic)
-    vec2 texSize = textureSize(uScreenTexture, 0);
-    float pixelW = uPixelSize / texSize.x;
-    float pixelH = uPixelSize / texSize.y;
-    float newX = floor(vUV.x / pixelW) * pixelW + 0.5 * pixelW;
-    float newY = floor(vUV.y / pixelH) * pixelH + 0.5 * pixelH;
-    vec4 effectColor = texture(uScreenTexture, vec2(newX, newY));
+    // 【修改】uv 映射移到 pp_fx_pixelate.glsl
+    vec2 cellUV = vUV;
+    fxPixelate(cellUV);
+    vec4 effectColor = sampleScene(uScreenTexture, cellUV);
 
     // 3. Apply comparison logic
     vec4 finalColor;
@@ -1,4 +1,5 @@
 #version 410 core
+#include "pp_common.glsl"
 out vec4 FragColor;
 in vec2 vUV;
 
@@ -10,24 +11,28 @@ uniform bool uEnableComparison;
 uniform float uBarPosition;
 uniform float uBarWidth = 0.005;
 
-// --- Watercolor Parameters (Hardcoded) ---
+// --- Watercolor Parameters ---
+// 【修改】階數可以用 #define 換掉 (main.cpp 重編一份)；扭曲強度改成 uniform
+#ifndef WATERCOLOR_LEVELS
+#define WATERCOLOR_LEVELS 6.0
+#endif
 const float blurSizeWC = 1.0 / 256.0; // Larger blur for watercolor
-const float noiseStrength = 0.02;    // How much noise distorts UVs [cite: 99]
-const float numColorLevelsWC = 6.0;  // Quantization levels [cite: 101]
+uniform float uNoiseStrength = 0.02; // How much noise distorts UVs [cite: 99]
+const float numColorLevelsWC = WATERCOLOR_LEVELS;  // Quantization levels [cite: 101]
 
 // Simple Box Blur
 vec4 applyBlurWC(sampler2D tex, vec2 uv) {
     vec4 sum = vec4(0.0);
     // (Similar to abstraction blur, but maybe use blurSizeWC)
-    sum += texture(tex, uv + vec2(-blurSizeWC, -blurSizeWC));
-    sum += texture(tex, uv + vec2( 0.0,       -blurSizeWC));
-    sum += texture(tex, uv + vec2( blurSizeWC, -blurSizeWC));
-    sum += texture(tex, uv + vec2(-blurSizeWC,  0.0));
-    sum += texture(tex, uv + vec2( 0.0,        0.0));
-    sum += texture(tex, uv + vec2( blurSizeWC,  0.0));
-    sum += texture(tex, uv + vec2(-blurSizeWC,  blurSizeWC));
-    sum += texture(tex, uv + vec2( 0.0,        blurSizeWC));
-    sum += texture(tex, uv + vec2( blurSizeWC,  blurSizeWC));
+    sum += sampleScene(tex, uv + vec2(-blurSizeWC, -blurSizeWC));
+    sum += sampleScene(tex, uv + vec2( 0.0,       -blurSizeWC));
+    sum += sampleScene(tex, uv + vec2( blurSizeWC, -blurSizeWC));
+    sum += sampleScene(tex, uv + vec2(-blurSizeWC,  0.0));
+    sum += sampleScene(tex, uv + vec2( 0.0,        0.0));
+    sum += sampleScene(tex, uv + vec2( blurSizeWC,  0.0));
+    sum += sampleScene(tex, uv + vec2(-blurSizeWC,  blurSizeWC));
+    sum += sampleScene(tex, uv + vec2( 0.0,        blurSizeWC));
+    sum += sampleScene(tex, uv + vec2( blurSizeWC,  blurSizeWC));
     return sum / 9.0;
 }
 
@@ -37,7 +42,7 @@ vec3 applyQuantizationWC(vec3 color) {
 }
 
 void main() {
-    vec4 originalColor = texture(uScreenTexture, vUV);
+    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);
 
     // 1. Blur the original image [cite: 96]
     vec4 blurredColor = applyBlurWC(uScreenTexture, vUV);
@@ -45,10 +50,10 @@ void main() {
     // 2. Get noise and distort UVs [cite: 97, 98]
     vec4 noise = texture(uNoiseTexture, vUV * 2.0); // Sample noise (scale UV for frequency)
     // Use noise to offset the UV coordinates for the blurred image
-    vec2 distortedUV = vUV + (noise.rg * 2.0 - 1.0) * noiseStrength; 
+    vec2 distortedUV = vUV + (noise.rg * 2.0 - 1.0) * uNoiseStrength; 
 
     // 3. Sample blurred texture with distorted UV [cite: 100]
-    vec4 distortedSample = texture(uScreenTexture, distortedUV); // Use original texture for sampling
+    vec4 distortedSample = sampleScene(uScreenTexture, distortedUV); // Use original texture for sampling
 
     // 4. Quantize the result [cite: 101]
     vec3 quantizedColor = applyQuantizationWC(distortedSample.rgb);
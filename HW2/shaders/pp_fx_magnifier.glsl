@@ -0,0 +1,15 @@
+// 【新增】Magnifier 的 uv 映射 (pp_fs_magnifier.glsl 和 main.cpp 產生的 fused shader 共用)
+// 回傳 false 表示映射到畫面外 (畫黑色)
+uniform vec2 uMousePos;   // Mouse position (0.0 to 1.0, Y flipped)
+uniform float uRadius = 0.2; // Magnifier radius (normalized)
+uniform float uZoom = 2.0;   // Zoom factor
+
+bool fxMagnifier(inout vec2 uv) {
+    // If inside the radius, calculate zoomed UV
+    if (distance(uv, uMousePos) < uRadius) {
+        vec2 relativeUV = (uv - uMousePos) / uRadius;
+        relativeUV /= uZoom;
+        uv = uMousePos + relativeUV * uRadius;
+    }
+    return uv.x >= 0.0 && uv.x <= 1.0 && uv.y >= 0.0 && uv.y <= 1.0;
+}
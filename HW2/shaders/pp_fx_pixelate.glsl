@@ -0,0 +1,12 @@
+// 【新增】Pixelization 的 uv 映射 (pp_fs_pixelate.glsl 和 fused shader 共用)
+uniform float uPixelSize = 64.0;
+uniform vec2 uViewportSize; // 輸出的大小 (pixel)
+
+bool fxPixelate(inout vec2 uv) {
+    // 【修改】格子數 = ceil(螢幕 / uPixelSize)，原本用 textureSize 算，輸入比螢幕大時格子會跟著變
+    // 場景是用 main.cpp 的低解析度路徑畫的時候 (一格一個 texel)，格子中心剛好落在 texel 中心，
+    // 所以 bilinear 取樣等於 nearest
+    vec2 cells = ceil(uViewportSize / uPixelSize);
+    uv = (floor(uv * cells) + 0.5) / cells;
+    return true;
+}
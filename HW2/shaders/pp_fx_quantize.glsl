@@ -0,0 +1,9 @@
+// 【新增】Color quantization (point-wise)，跟 abstraction 裡的一樣是 8 階
+#ifndef QUANTIZE_LEVELS
+#define QUANTIZE_LEVELS 8.0
+#endif
+const float quantizeLevels = QUANTIZE_LEVELS;
+
+vec4 fxQuantize(vec4 color) {
+    return vec4(floor(color.rgb * quantizeLevels) / quantizeLevels, color.a);
+}
@@ -0,0 +1,15 @@
+// 【新增】Sine Wave 的 uv 映射 (pp_fs_sinewave.glsl 和 fused shader 共用)
+uniform float uTime;      // 目前時間 (用於動畫)
+
+// 【修改】power1 / power2 改成 uniform (main.cpp 本來就有傳 uPower1 / uPower2，只是之前沒用到)
+uniform float uPower1 = 0.02;
+uniform float uPower2 = 20.0;
+const float PI = 3.14159265;
+
+bool fxSineWave(inout vec2 uv) {
+    float offset = uTime; // PDF 上的 offset 就是時間
+    // 根據 PDF 公式修改 x 座標
+    uv.x += uPower1 * sin(uv.y * uPower2 * PI + offset);
+    // 檢查扭曲後的 UV 是否還在 0.0 ~ 1.0 範圍內
+    return uv.x >= 0.0 && uv.x <= 1.0 && uv.y >= 0.0 && uv.y <= 1.0;
+}
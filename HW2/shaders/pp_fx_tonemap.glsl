@@ -0,0 +1,4 @@
+// 【新增】Tone mapping (point-wise)：接在 bloom (R11G11B10F / RGBA16F) 後面把超過 1 的亮度壓回來
+vec4 fxToneMap(vec4 color) {
+    return vec4(color.rgb / (color.rgb + vec3(1.0)), color.a); // Reinhard tone mapping
+}
@@ -0,0 +1,18 @@
+// 【新增】Temporal amortization：每幀只重算 1 / uTemporalPeriod 的 16x16 tile，其他 tile 用相機矩陣
+// 從上一幀的輸出 reproject 過來 (pp_cs_temporal_reproject.glsl)；reproject 失敗的 tile 也加進這幀要算的清單。
+// pp_vs.glsl 一個 instance 畫清單上的一塊，pp_cs_abstraction.glsl 一個 work group 算一塊，整個 warp 一起跳過。
+// 【修改】原本逐 pixel 挑：每個 warp 幾乎都有要算的 pixel，效果照樣整個跑，反而比關掉還慢
+const int TEMPORAL_TILE = 16;    // 跟 main.cpp 的 TEMPORAL_TILE 一樣
+uniform int uTemporalPeriod = 1; // 1 = 一般的 draw / dispatch，2 = 棋盤格，4 = 2x2 輪流
+uniform int uTemporalPhase = 0;
+
+// 這幀輪到重算的 tile
+bool temporalDue(ivec2 tile) {
+    int slot = (uTemporalPeriod == 2) ? ((tile.x + tile.y) & 1) : ((tile.x & 1) + 2 * (tile.y & 1));
+    return slot == uTemporalPhase;
+}
+
+// tile 清單裡一格是 x | (y << 16)
+ivec2 temporalUnpackTile(uint packed) {
+    return ivec2(int(packed & 0xFFFFu), int(packed >> 16));
+}
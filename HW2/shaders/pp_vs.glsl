@@ -1,10 +1,21 @@
 #version 410 core
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in uint aTemporalTile; // 【新增】temporal：每個 instance 一塊 tile (g_temporalTileVAO 才有)
 
 out vec2 vUV;
 
+#include "pp_temporal.glsl"
+uniform vec2 uViewportSize;
+
 void main() {
     gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);
     vUV = aTexCoords;
-}
\ No newline at end of file
+    // 【新增】temporal：用 glDrawArraysIndirect 畫 tile 清單，每個 instance 把 quad 縮成清單上的一塊。
+    // 畫面邊上的 tile 夾到邊界
+    if (uTemporalPeriod > 1) {
+        vec2 pixel = min(vec2(temporalUnpackTile(aTemporalTile) + ivec2(aTexCoords)) * float(TEMPORAL_TILE), uViewportSize);
+        vUV = pixel / uViewportSize;
+        gl_Position = vec4(vUV * 2.0 - 1.0, 0.0, 1.0);
+    }
+}
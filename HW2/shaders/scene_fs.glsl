@@ -1,16 +1,99 @@
-#version 410 core
+#version 460 core
 in vec2 vUV;
 in vec3 vN; // 這是 World-space Normal
+flat in uvec2 vTexSlot; // (bucket, layer)
+in vec3 vWorldPos;
+in float vViewDepth;
 out vec4 FragColor;
 
-uniform sampler2D uTex0;
+// 同尺寸的貼圖放在同一個 texture array，數量要跟 main.cpp 的 MAX_TEXTURE_BUCKETS 一樣
+uniform sampler2DArray uBucket[8];
 uniform vec3 uLightDir = normalize(vec3(-0.5, -1.0, -0.3));
 uniform float uAmbient = 0.25;
 
+// 【新增】clustered forward：cluster_cull_cs 已經把每個 froxel 會碰到的光源列好，這裡只跑自己那格
+#define MAX_LIGHTS_PER_CLUSTER 128u // 要跟 main.cpp 的 ClusteredLighting::MAX_LIGHTS_PER_CLUSTER 一樣
+struct Light {
+    vec4 posRadius;   // world-space 位置, 影響半徑
+    vec4 colorType;   // rgb, w: 0 = point, 1 = spot
+    vec4 spotDirCos;  // world-space 方向, cos(外角)
+};
+layout (std430, binding = 2) readonly buffer Lights {
+    Light lights[];
+};
+layout (std430, binding = 4) readonly buffer ClusterLightCount {
+    uint clusterLightCount[];
+};
+layout (std430, binding = 5) readonly buffer ClusterLightIndex {
+    uint clusterLightIndex[];
+};
+
+uniform bool uClusteredLights = false;
+uniform bool uShowClusterHeat = false;
+uniform uvec3 uClusterGrid;
+uniform vec2 uViewportSize;
+uniform float uClusterNear;
+uniform float uClusterFar;
+
+uint clusterIndex()
+{
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / uViewportSize * vec2(uClusterGrid.xy)), uClusterGrid.xy - 1u);
+    float slice = log(max(vViewDepth, uClusterNear) / uClusterNear) / log(uClusterFar / uClusterNear) * float(uClusterGrid.z);
+    uint z = min(uint(slice), uClusterGrid.z - 1u);
+    return tile.x + uClusterGrid.x * (tile.y + uClusterGrid.y * z);
+}
+
+vec3 localLight(Light light, vec3 N)
+{
+    vec3 toLight = light.posRadius.xyz - vWorldPos;
+    float dist2 = dot(toLight, toLight);
+    float radius = light.posRadius.w;
+    if (dist2 >= radius * radius) return vec3(0.0);
+
+    vec3 L = toLight * inversesqrt(max(dist2, 1e-8));
+    // 在半徑處平滑衰減到 0，cluster 剔除才不會看到硬邊
+    float r4 = dist2 * dist2 / (radius * radius * radius * radius);
+    float window = clamp(1.0 - r4, 0.0, 1.0);
+    float attenuation = window * window / (dist2 + 1.0);
+    if (light.colorType.w > 0.5) {
+        float cosAngle = dot(-L, light.spotDirCos.xyz);
+        attenuation *= smoothstep(light.spotDirCos.w, mix(light.spotDirCos.w, 1.0, 0.2), cosAngle);
+    }
+    return light.colorType.rgb * max(dot(N, L), 0.0) * attenuation;
+}
+
 void main() {
-    vec3 albedo = texture(uTex0, vUV).rgb;
+    // sampler array 只能用常數 index，所以用 switch 選 bucket (同一個 draw 的 fragment 走同一條分支)
+    vec3 uvw = vec3(vUV, float(vTexSlot.y));
+    vec3 albedo;
+    switch (vTexSlot.x) {
+        case 0u: albedo = texture(uBucket[0], uvw).rgb; break;
+        case 1u: albedo = texture(uBucket[1], uvw).rgb; break;
+        case 2u: albedo = texture(uBucket[2], uvw).rgb; break;
+        case 3u: albedo = texture(uBucket[3], uvw).rgb; break;
+        case 4u: albedo = texture(uBucket[4], uvw).rgb; break;
+        case 5u: albedo = texture(uBucket[5], uvw).rgb; break;
+        case 6u: albedo = texture(uBucket[6], uvw).rgb; break;
+        default: albedo = texture(uBucket[7], uvw).rgb; break;
+    }
     vec3 N_norm = normalize(vN); // 法線已經在 world-space
     float diff = max(dot(N_norm, -uLightDir), 0.0);
     vec3 color = albedo * (uAmbient + (1.0 - uAmbient) * diff);
+
+    if (uClusteredLights) {
+        uint cluster = clusterIndex();
+        uint count = clusterLightCount[cluster];
+        vec3 local = vec3(0.0);
+        for (uint i = 0u; i < count; ++i) {
+            local += localLight(lights[clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + i]], N_norm);
+        }
+        color += albedo * local;
+        if (uShowClusterHeat) {
+            // 每格光源數：藍 (0) -> 綠 -> 紅 (>= 32)
+            float t = clamp(float(count) / 32.0, 0.0, 1.0);
+            vec3 heat = t < 0.5 ? mix(vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 0.0), t * 2.0) : mix(vec3(0.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), t * 2.0 - 1.0);
+            color = mix(color, heat, 0.5);
+        }
+    }
     FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#version 460 core
+// 【新增】Deferred 的 geometry pass：只寫 albedo / 法線，打光交給 deferred_lighting_cs
+in vec2 vUV;
+in vec3 vN; // World-space Normal
+flat in uvec2 vTexSlot; // (bucket, layer)
+
+layout (location = 1) out vec4 gAlbedo; // fbo 的 COLOR_ATTACHMENT1
+layout (location = 2) out vec4 gNormal; // fbo 的 COLOR_ATTACHMENT2
+
+// 同尺寸的貼圖放在同一個 texture array，數量要跟 main.cpp 的 MAX_TEXTURE_BUCKETS 一樣
+uniform sampler2DArray uBucket[8];
+
+void main() {
+    vec3 uvw = vec3(vUV, float(vTexSlot.y));
+    vec3 albedo;
+    switch (vTexSlot.x) {
+        case 0u: albedo = texture(uBucket[0], uvw).rgb; break;
+        case 1u: albedo = texture(uBucket[1], uvw).rgb; break;
+        case 2u: albedo = texture(uBucket[2], uvw).rgb; break;
+        case 3u: albedo = texture(uBucket[3], uvw).rgb; break;
+        case 4u: albedo = texture(uBucket[4], uvw).rgb; break;
+        case 5u: albedo = texture(uBucket[5], uvw).rgb; break;
+        case 6u: albedo = texture(uBucket[6], uvw).rgb; break;
+        default: albedo = texture(uBucket[7], uvw).rgb; break;
+    }
+    gAlbedo = vec4(albedo, 1.0);
+    gNormal = vec4(normalize(vN), 0.0);
+}
@@ -1,4 +1,4 @@
-#version 410 core
+#version 460 core
 in vec2 vUV;
 in vec3 vN; // World-space Normal
 out vec4 FragColor;
@@ -1,8 +1,16 @@
-#version 410 core
+#version 460 core
 layout (location = 0) in vec3 vPos;
 layout (location = 1) in vec3 vNormal;
 layout (location = 2) in vec2 vUV_in;
 
+// 材質表 (main.cpp 的 Model::bindMaterials)
+layout (std430, binding = 0) readonly buffer DrawMaterial {
+    uint drawMaterial[];   // draw index (gl_BaseInstance) -> material index
+};
+layout (std430, binding = 1) readonly buffer Materials {
+    uvec2 materialSlot[];  // material index -> (bucket, layer)
+};
+
 // 來自 main.cpp 的 Uniforms
 uniform mat4 uP;
 uniform mat4 uV;
@@ -11,6 +19,9 @@ uniform mat4 uM;
 // 傳遞給 Fragment Shader 的變數
 out vec3 vN;     // World-space Normal
 out vec2 vUV;
+flat out uvec2 vTexSlot; // 這個 draw 的貼圖在哪個 bucket 的哪一層
+out vec3 vWorldPos;      // clustered 光源用
+out float vViewDepth;    // 相機前方的距離 (= -view-space z)，用來找 cluster 的 z 切片
 
 void main()
 {
@@ -24,6 +35,13 @@ void main()
     // 傳遞 UV
     vUV = vUV_in;
 
+    // MultiDraw 時 gl_BaseInstance = 這個 draw 在 indirect buffer 的 index
+    vTexSlot = materialSlot[drawMaterial[gl_BaseInstance]];
+
+    vWorldPos = worldPos.xyz;
+    vec4 viewPos = uV * worldPos;
+    vViewDepth = -viewPos.z;
+
     // 計算最終的 Clip-space 位置
-    gl_Position = uP * uV * worldPos;
+    gl_Position = uP * viewPos;
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#version 460 core
+// 【新增】SSAO：在 1/uScale 解析度算，每個 invocation 一個低解析度 pixel
+// 法線用深度重建 (forward / deferred 都能用)，半球 kernel 每個 pixel 轉一個角度，雜訊交給 bilateral upsample 糊掉
+// 輸出 rg16f：r = AO (1 = 沒有遮蔽), g = 線性深度 (upsample 判斷邊界用)
+layout (local_size_x = 8, local_size_y = 8) in;
+
+#define MAX_KERNEL_SIZE 32
+
+uniform sampler2D uDepth;
+layout (rg16f, binding = 1) writeonly uniform image2D uAOImage;
+
+uniform ivec2 uRenderSize; // 動態解析度：深度只有左下角這塊有效
+uniform ivec2 uAOSize;     // uAOImage 裡這幀要算的範圍
+uniform mat4 uP;
+uniform mat4 uInvP;
+uniform vec3 uKernel[MAX_KERNEL_SIZE]; // tangent space 半球，z 朝法線
+uniform int uKernelSize = 16;
+uniform float uRadius = 0.5;
+uniform float uBias = 0.02;
+uniform int uScale = 2;
+
+ivec2 gDepthSize;
+
+vec3 viewPosAt(ivec2 pixel)
+{
+    pixel = clamp(pixel, ivec2(0), gDepthSize - 1);
+    float depth = texelFetch(uDepth, pixel, 0).r;
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(gDepthSize);
+    vec4 p = uInvP * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return p.xyz / p.w;
+}
+
+// Jimenez 2014 的 interleaved gradient noise
+float interleavedGradientNoise(vec2 p)
+{
+    return fract(52.9829189 * fract(dot(p, vec2(0.06711056, 0.00583715))));
+}
+
+void main()
+{
+    ivec2 aoPixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(aoPixel, uAOSize))) return;
+    gDepthSize = uRenderSize;
+
+    ivec2 center = aoPixel * uScale + uScale / 2;
+    float depth = texelFetch(uDepth, clamp(center, ivec2(0), gDepthSize - 1), 0).r;
+    if (depth >= 1.0) {
+        imageStore(uAOImage, aoPixel, vec4(1.0, 65504.0, 0.0, 0.0)); // 背景：half float 的最大值
+        return;
+    }
+
+    // 左右 / 上下各取深度差小的那一邊，物體邊緣的法線才不會被背景拉歪
+    vec3 P = viewPosAt(center);
+    vec3 dxA = viewPosAt(center + ivec2(uScale, 0)) - P, dxB = P - viewPosAt(center - ivec2(uScale, 0));
+    vec3 dyA = viewPosAt(center + ivec2(0, uScale)) - P, dyB = P - viewPosAt(center - ivec2(0, uScale));
+    vec3 ddx = abs(dxA.z) < abs(dxB.z) ? dxA : dxB;
+    vec3 ddy = abs(dyA.z) < abs(dyB.z) ? dyA : dyB;
+    vec3 N = normalize(cross(ddx, ddy));
+    if (dot(N, P) > 0.0) N = -N;
+
+    float angle = 6.2831853 * interleavedGradientNoise(vec2(aoPixel));
+    vec3 r = vec3(cos(angle), sin(angle), 0.0);
+    vec3 T = r - N * dot(r, N);
+    T = dot(T, T) > 1e-6 ? normalize(T) : normalize(cross(N, vec3(0.0, 1.0, 0.0)));
+    mat3 TBN = mat3(T, cross(N, T), N);
+
+    float occlusion = 0.0;
+    int count = min(uKernelSize, MAX_KERNEL_SIZE);
+    for (int i = 0; i < count; ++i) {
+        vec3 s = P + TBN * uKernel[i] * uRadius;
+        vec4 clip = uP * vec4(s, 1.0);
+        vec2 uv = clip.xy / clip.w * 0.5 + 0.5;
+        if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) continue;
+        float sceneZ = viewPosAt(ivec2(uv * vec2(gDepthSize))).z;
+        // 太遠的遮擋物 (例如背景牆) 不算，避免物體周圍出現黑框
+        float range = smoothstep(0.0, 1.0, uRadius / max(abs(P.z - sceneZ), 1e-4));
+        occlusion += (sceneZ >= s.z + uBias ? 1.0 : 0.0) * range;
+    }
+    float ao = 1.0 - occlusion / float(max(count, 1));
+    imageStore(uAOImage, aoPixel, vec4(ao, -P.z, 0.0, 0.0));
+}
@@ -0,0 +1,62 @@
+#version 460 core
+// 【新增】把低解析度 AO 用 depth-aware bilateral 放大回全解析度，直接乘進場景顏色
+// 權重 = 雙線性權重 * 深度相似度，跨物體邊緣的低解析度樣本幾乎不會被採用
+layout (local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D uDepth;
+uniform sampler2D uAO; // ssao_cs 的輸出 (r = AO, g = 線性深度)
+layout (rgba8, binding = 0) uniform image2D uSceneColor;
+
+uniform ivec2 uRenderSize; // 動態解析度：只處理這幀畫到的範圍
+uniform ivec2 uAOSize;
+uniform mat4 uInvP;
+uniform int uScale = 2;
+uniform float uStrength = 1.0;
+uniform float uDepthSharpness = 20.0; // 越大越不跨邊界
+uniform bool uShowAO = false;
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = uRenderSize;
+    if (any(greaterThanEqual(pixel, size))) return;
+
+    float depth = texelFetch(uDepth, pixel, 0).r;
+    if (depth >= 1.0) {
+        if (uShowAO) imageStore(uSceneColor, pixel, vec4(1.0));
+        return;
+    }
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(size);
+    vec4 p = uInvP * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    float viewZ = -p.z / p.w;
+
+    ivec2 aoSize = uAOSize;
+    vec2 lowPos = (vec2(pixel) + 0.5) / float(uScale) - 0.5;
+    ivec2 base = ivec2(floor(lowPos));
+    vec2 f = lowPos - vec2(base);
+
+    float sum = 0.0, weightSum = 0.0;
+    float nearestAO = 1.0, nearestDiff = 1e30;
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 0; i < 2; ++i) {
+            vec2 s = texelFetch(uAO, clamp(base + ivec2(i, j), ivec2(0), aoSize - 1), 0).rg;
+            float bilinear = (i == 0 ? 1.0 - f.x : f.x) * (j == 0 ? 1.0 - f.y : f.y);
+            float diff = abs(s.g - viewZ) / max(viewZ, 1e-4);
+            float w = bilinear * exp(-diff * uDepthSharpness);
+            sum += s.r * w;
+            weightSum += w;
+            if (diff < nearestDiff) { nearestDiff = diff; nearestAO = s.r; }
+        }
+    }
+    // 四個樣本都在別的物體上 (細小的幾何)，退回深度最接近的那個
+    float ao = weightSum > 1e-4 ? sum / weightSum : nearestAO;
+    ao = mix(1.0, ao, uStrength);
+
+    if (uShowAO) {
+        imageStore(uSceneColor, pixel, vec4(vec3(ao), 1.0));
+    }
+    else {
+        vec4 color = imageLoad(uSceneColor, pixel);
+        imageStore(uSceneColor, pixel, vec4(color.rgb * ao, color.a));
+    }
+}
@@ -0,0 +1,643 @@
+#pragma once
+
+// CPU reference implementation of the HW2 post effects, no GL calls at all.
+//
+// Mirrors shaders/pp_fs_*.glsl (and the bloom mip chain in main.cpp) on float RGBA images, so the
+// effects can be checked and timed on machines without a GPU and captured frames can be processed
+// offline:
+//
+//   CpuPostEffects post;                                      // starts the worker threads
+//   CpuImage frame = CpuImage::fromRGBA8(pixels, w, h);       // row 0 = bottom, like glReadPixels
+//   CpuPostParams params;                                     // same defaults as the shaders
+//   post.apply(CPU_POST_BLOOM, frame, result, params);
+//   result.toRGBA8(pixels);
+//
+// Texture reads follow GL: bilinear, clamp to edge for the scene, repeat for the noise texture,
+// texel centers at (i + 0.5) / size, pixel (x, y) shaded at uv = ((x + 0.5) / w, (y + 0.5) / h).
+// The output is cut into tiles of rows that a small pool of worker threads (and the calling
+// thread) pull from a shared counter. Every pixel is one SSE register when available; with AVX2
+// both texels of a bilinear row are fetched with one load and the point-wise effects run two
+// pixels at a time. CPU_POST_EFFECTS_NO_SIMD forces the scalar path.
+//
+// Not mirrored: the unsharp mask of dynamic resolution (this always runs at full resolution),
+// temporal reuse, and the filtering precision / R11G11B10F rounding of the GPU, so expect small
+// differences (about 1/255 in RGBA8) rather than bit-exact results.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(CPU_POST_EFFECTS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CPU_POST_EFFECTS_SSE 1
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define CPU_POST_EFFECTS_AVX2 1
+#include <immintrin.h>
+#else
+#define CPU_POST_EFFECTS_AVX2 0
+#endif
+#else
+#define CPU_POST_EFFECTS_SSE 0
+#define CPU_POST_EFFECTS_AVX2 0
+#endif
+
+// same order as POST_EFFECT_NAMES in main.cpp
+enum CpuPostEffect
+{
+	CPU_POST_PASSTHROUGH = 0,
+	CPU_POST_ABSTRACTION,
+	CPU_POST_WATERCOLOR,
+	CPU_POST_MAGNIFIER,
+	CPU_POST_BLOOM,
+	CPU_POST_PIXELATE,
+	CPU_POST_SINEWAVE,
+	CPU_POST_TONEMAP,
+	CPU_POST_QUANTIZE,
+	CPU_POST_EFFECT_COUNT
+};
+
+// defaults are the shader defaults (and the GUI defaults in g_postParams)
+struct CpuPostParams
+{
+	bool enableComparison = false;
+	float barPosition = 0.5f;
+	float barWidth = 0.005f;
+
+	float abstractionBlurSize = 1.0f / 512.0f;
+	float abstractionLevels = 8.0f;
+	float abstractionEdgeThreshold = 0.2f;
+
+	float watercolorLevels = 6.0f;
+	float noiseStrength = 0.02f;
+
+	float mouseX = 0.5f, mouseY = 0.5f; // uv, y up
+	float radius = 0.2f;
+	float zoom = 2.0f;
+
+	float bloomIntensity = 3.5f;
+	int bloomLevels = 2;                // BLOOM_LEVELS in main.cpp
+	float bloomUpsampleWeight = 0.2f;   // BLOOM_UPSAMPLE_WEIGHT in main.cpp
+
+	float pixelSize = 64.0f;
+
+	float time = 0.0f;
+	float power1 = 0.02f;
+	float power2 = 20.0f;
+
+	float quantizeLevels = 8.0f;
+};
+
+// RGBA float image, 4 floats per pixel, rows bottom to top (same layout as a GL texture)
+struct CpuImage
+{
+	int width = 0;
+	int height = 0;
+	std::vector<float> pixels;
+
+	void resize(const int w, const int h)
+	{
+		width = w;
+		height = h;
+		pixels.resize((size_t)w * h * 4);
+	}
+
+	float* row(const int y) { return &pixels[(size_t)y * width * 4]; }
+	const float* row(const int y) const { return &pixels[(size_t)y * width * 4]; }
+
+	static CpuImage fromRGBA8(const uint8_t* data, const int w, const int h)
+	{
+		CpuImage image;
+		image.resize(w, h);
+		for (size_t i = 0; i < image.pixels.size(); i++) {
+			image.pixels[i] = data[i] * (1.0f / 255.0f);
+		}
+		return image;
+	}
+
+	// clamps to [0, 1] and rounds, like writing to an RGBA8 target
+	void toRGBA8(uint8_t* data) const
+	{
+		size_t i = 0;
+		const size_t count = pixels.size();
+#if CPU_POST_EFFECTS_AVX2
+		const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), scale = _mm256_set1_ps(255.0f), half = _mm256_set1_ps(0.5f);
+		for (; i + 8 <= count; i += 8) {
+			const __m256 c = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&pixels[i]), zero), one);
+			const __m256i v = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(c, scale), half));
+			const __m128i packed16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+			_mm_storel_epi64((__m128i*)(data + i), _mm_packus_epi16(packed16, packed16));
+		}
+#endif
+		for (; i < count; i++) {
+			const float c = std::min(std::max(pixels[i], 0.0f), 1.0f);
+			data[i] = (uint8_t)(c * 255.0f + 0.5f);
+		}
+	}
+};
+
+// one RGBA pixel; a single SSE register when available
+#if CPU_POST_EFFECTS_SSE
+struct CpuPixel
+{
+	__m128 v;
+
+	static CpuPixel load(const float* p) { return { _mm_loadu_ps(p) }; }
+	static CpuPixel set(const float r, const float g, const float b, const float a) { return { _mm_set_ps(a, b, g, r) }; }
+	static CpuPixel splat(const float s) { return { _mm_set1_ps(s) }; }
+	void store(float* p) const { _mm_storeu_ps(p, v); }
+
+	CpuPixel operator+(const CpuPixel o) const { return { _mm_add_ps(v, o.v) }; }
+	CpuPixel operator-(const CpuPixel o) const { return { _mm_sub_ps(v, o.v) }; }
+	CpuPixel operator*(const CpuPixel o) const { return { _mm_mul_ps(v, o.v) }; }
+	CpuPixel operator/(const CpuPixel o) const { return { _mm_div_ps(v, o.v) }; }
+	CpuPixel operator*(const float s) const { return { _mm_mul_ps(v, _mm_set1_ps(s)) }; }
+
+	CpuPixel floor() const
+	{
+		// truncate, then step down where that rounded up (negative values)
+		const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+		return { _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f))) };
+	}
+
+	CpuPixel withAlpha(const float a) const
+	{
+		const __m128 rgb = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		return { _mm_or_ps(_mm_and_ps(v, rgb), _mm_set_ps(a, 0.0f, 0.0f, 0.0f)) };
+	}
+
+	float rgbLength() const
+	{
+		const __m128 sq = _mm_mul_ps(v, v);
+		alignas(16) float s[4];
+		_mm_store_ps(s, sq);
+		return std::sqrt(s[0] + s[1] + s[2]);
+	}
+
+	float luminance() const
+	{
+		alignas(16) float s[4];
+		_mm_store_ps(s, v);
+		return s[0] * 0.2126f + s[1] * 0.7152f + s[2] * 0.0722f;
+	}
+
+	float channel(const int i) const
+	{
+		alignas(16) float s[4];
+		_mm_store_ps(s, v);
+		return s[i];
+	}
+};
+#else
+struct CpuPixel
+{
+	float v[4];
+
+	static CpuPixel load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+	static CpuPixel set(const float r, const float g, const float b, const float a) { return { { r, g, b, a } }; }
+	static CpuPixel splat(const float s) { return { { s, s, s, s } }; }
+	void store(float* p) const { p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3]; }
+
+	CpuPixel operator+(const CpuPixel o) const { return { { v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2], v[3] + o.v[3] } }; }
+	CpuPixel operator-(const CpuPixel o) const { return { { v[0] - o.v[0], v[1] - o.v[1], v[2] - o.v[2], v[3] - o.v[3] } }; }
+	CpuPixel operator*(const CpuPixel o) const { return { { v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2], v[3] * o.v[3] } }; }
+	CpuPixel operator/(const CpuPixel o) const { return { { v[0] / o.v[0], v[1] / o.v[1], v[2] / o.v[2], v[3] / o.v[3] } }; }
+	CpuPixel operator*(const float s) const { return { { v[0] * s, v[1] * s, v[2] * s, v[3] * s } }; }
+
+	CpuPixel floor() const { return { { std::floor(v[0]), std::floor(v[1]), std::floor(v[2]), std::floor(v[3]) } }; }
+	CpuPixel withAlpha(const float a) const { return { { v[0], v[1], v[2], a } }; }
+	float rgbLength() const { return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]); }
+	float luminance() const { return v[0] * 0.2126f + v[1] * 0.7152f + v[2] * 0.0722f; }
+	float channel(const int i) const { return v[i]; }
+};
+#endif
+
+class CpuPostEffects
+{
+public:
+	static const int TILE_ROWS = 16;
+
+	// threads = 0 picks hardware_concurrency - 1
+	CpuPostEffects(unsigned int threads = 0)
+	{
+		if (threads == 0) {
+			const unsigned int hw = std::thread::hardware_concurrency();
+			threads = (hw > 1) ? hw - 1 : 0u;
+		}
+		for (unsigned int i = 0; i < threads; i++) {
+			m_workers.emplace_back(&CpuPostEffects::workerLoop, this);
+		}
+	}
+
+	~CpuPostEffects()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	CpuPostEffects(const CpuPostEffects&) = delete;
+	CpuPostEffects& operator=(const CpuPostEffects&) = delete;
+
+	int threadCount() const { return (int)m_workers.size() + 1; }
+
+	// dst gets the size of src; noise is the watercolor noise texture (nullptr = no distortion).
+	// Not reentrant: one apply at a time per instance.
+	void apply(const int effect, const CpuImage& src, CpuImage& dst, const CpuPostParams& p, const CpuImage* noise = nullptr)
+	{
+		switch (effect) {
+		case CPU_POST_ABSTRACTION: abstraction(src, dst, p); break;
+		case CPU_POST_WATERCOLOR: watercolor(src, dst, p, noise); break;
+		case CPU_POST_MAGNIFIER: magnifier(src, dst, p); break;
+		case CPU_POST_BLOOM: bloom(src, dst, p); break;
+		case CPU_POST_PIXELATE: pixelate(src, dst, p); break;
+		case CPU_POST_SINEWAVE: sineWave(src, dst, p); break;
+		case CPU_POST_TONEMAP:
+		case CPU_POST_QUANTIZE:
+		default: pointWise(effect, src, dst, p); break;
+		}
+	}
+
+	// bilinear, clamp to edge (sampleScene with uUVScale = 1)
+	static CpuPixel sampleClamp(const CpuImage& image, const float u, const float v)
+	{
+		const float tx = std::min(std::max(u * image.width - 0.5f, -1.0f), (float)image.width);
+		const float ty = std::min(std::max(v * image.height - 0.5f, -1.0f), (float)image.height);
+		const float x0f = std::floor(tx), y0f = std::floor(ty);
+		const int x0 = (int)x0f, y0 = (int)y0f;
+		return bilinear(image,
+			std::min(std::max(x0, 0), image.width - 1), std::min(std::max(x0 + 1, 0), image.width - 1),
+			std::min(std::max(y0, 0), image.height - 1), std::min(std::max(y0 + 1, 0), image.height - 1),
+			tx - x0f, ty - y0f);
+	}
+
+	// bilinear, GL_REPEAT (the noise texture)
+	static CpuPixel sampleRepeat(const CpuImage& image, const float u, const float v)
+	{
+		const float tx = (u - std::floor(u)) * image.width - 0.5f;
+		const float ty = (v - std::floor(v)) * image.height - 0.5f;
+		const float x0f = std::floor(tx), y0f = std::floor(ty);
+		const int x0 = ((int)x0f + image.width) % image.width, y0 = ((int)y0f + image.height) % image.height;
+		return bilinear(image, x0, (x0 + 1) % image.width, y0, (y0 + 1) % image.height, tx - x0f, ty - y0f);
+	}
+
+private:
+	static CpuPixel bilinear(const CpuImage& image, const int x0, const int x1, const int y0, const int y1, const float fx, const float fy)
+	{
+		const float* row0 = image.row(y0);
+		const float* row1 = image.row(y1);
+#if CPU_POST_EFFECTS_AVX2
+		if (x1 == x0 + 1) {
+			// both texels of a row are adjacent: one load per row, then blend both rows at once
+			// (same order of operations as the path below, so the results are identical)
+			const __m256 lower = _mm256_loadu_ps(row0 + x0 * 4);
+			const __m256 upper = _mm256_loadu_ps(row1 + x0 * 4);
+			const __m256 left = _mm256_permute2f128_ps(lower, upper, 0x20);
+			const __m256 right = _mm256_permute2f128_ps(lower, upper, 0x31);
+			const __m256 mixed = _mm256_add_ps(left, _mm256_mul_ps(_mm256_sub_ps(right, left), _mm256_set1_ps(fx)));
+			const __m128 l = _mm256_castps256_ps128(mixed), u = _mm256_extractf128_ps(mixed, 1);
+			return { _mm_add_ps(l, _mm_mul_ps(_mm_sub_ps(u, l), _mm_set1_ps(fy))) };
+		}
+#endif
+		const CpuPixel a = CpuPixel::load(row0 + x0 * 4), b = CpuPixel::load(row0 + x1 * 4);
+		const CpuPixel c = CpuPixel::load(row1 + x0 * 4), d = CpuPixel::load(row1 + x1 * 4);
+		const CpuPixel lower = a + (b - a) * fx;
+		const CpuPixel upper = c + (d - c) * fx;
+		return lower + (upper - lower) * fy;
+	}
+
+	static float smoothstep(const float e0, const float e1, const float x)
+	{
+		const float t = std::min(std::max((x - e0) / (e1 - e0), 0.0f), 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	static CpuPixel quantize(const CpuPixel c, const float levels)
+	{
+		return (c * levels).floor() * (1.0f / levels);
+	}
+
+	// every pixel of dst from shader(u, v), no comparison bar (intermediate passes)
+	template<class Shader>
+	void run(CpuImage& dst, const Shader& shader)
+	{
+		const float invW = 1.0f / dst.width, invH = 1.0f / dst.height;
+		forEachTile(dst.height, [&](const int y0, const int y1) {
+			for (int y = y0; y < y1; y++) {
+				const float v = (y + 0.5f) * invH;
+				float* out = dst.row(y);
+				for (int x = 0; x < dst.width; x++) {
+					shader((x + 0.5f) * invW, v).store(out + x * 4);
+				}
+			}
+		});
+	}
+
+	// a final pass of one of the pp_fs_*.glsl shaders: original left of the bar, red bar, effect elsewhere
+	template<class Shader>
+	void shade(const CpuImage& src, CpuImage& dst, const CpuPostParams& p, const Shader& effect)
+	{
+		dst.resize(src.width, src.height);
+		run(dst, effect);
+		applyComparison(src, dst, p);
+	}
+
+	void applyComparison(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		if (!p.enableComparison) {
+			return;
+		}
+		// the same per-pixel tests as the shaders, turned into column ranges once
+		const float invW = 1.0f / dst.width;
+		int left = 0, barBegin = dst.width, barEnd = dst.width;
+		for (int x = 0; x < dst.width; x++) {
+			const float u = (x + 0.5f) * invW;
+			if (u < p.barPosition) {
+				left = x + 1;
+			}
+			if (std::fabs(u - p.barPosition) < p.barWidth * 0.5f) {
+				barBegin = std::min(barBegin, x);
+				barEnd = x + 1;
+			}
+		}
+		if (barBegin == dst.width) {
+			barEnd = barBegin;
+		}
+		forEachTile(dst.height, [&](const int y0, const int y1) {
+			const CpuPixel red = CpuPixel::set(1.0f, 0.0f, 0.0f, 1.0f);
+			for (int y = y0; y < y1; y++) {
+				float* out = dst.row(y);
+				std::copy(src.row(y), src.row(y) + left * 4, out);
+				for (int x = barBegin; x < barEnd; x++) {
+					red.store(out + x * 4);
+				}
+			}
+		});
+	}
+
+	void abstraction(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		const float b = p.abstractionBlurSize;
+		shade(src, dst, p, [&](const float u, const float v) {
+			// the 3x3 box blur and the Sobel filter read the same 9 taps
+			CpuPixel t[3][3];
+			for (int j = 0; j < 3; j++) {
+				for (int i = 0; i < 3; i++) {
+					t[j][i] = sampleClamp(src, u + (i - 1) * b, v + (j - 1) * b);
+				}
+			}
+			const CpuPixel sum = t[0][0] + t[0][1] + t[0][2] + t[1][0] + t[1][1] + t[1][2] + t[2][0] + t[2][1] + t[2][2];
+			const CpuPixel quantized = quantize(sum * (1.0f / 9.0f), p.abstractionLevels);
+			const CpuPixel gx = t[0][2] + t[1][2] * 2.0f + t[2][2] - t[0][0] - t[1][0] * 2.0f - t[2][0];
+			const CpuPixel gy = t[2][0] + t[2][1] * 2.0f + t[2][2] - t[0][0] - t[0][1] * 2.0f - t[0][2];
+			const float edge = smoothstep(0.0f, p.abstractionEdgeThreshold, gx.rgbLength() + gy.rgbLength());
+			return (quantized * (1.0f - edge)).withAlpha(1.0f);
+		});
+	}
+
+	void watercolor(const CpuImage& src, CpuImage& dst, const CpuPostParams& p, const CpuImage* noise)
+	{
+		// the shader's blur result is never used, only the distorted sample is
+		shade(src, dst, p, [&](const float u, const float v) {
+			float du = 0.0f, dv = 0.0f;
+			if (noise && noise->width > 0) {
+				const CpuPixel n = sampleRepeat(*noise, u * 2.0f, v * 2.0f);
+				du = (n.channel(0) * 2.0f - 1.0f) * p.noiseStrength;
+				dv = (n.channel(1) * 2.0f - 1.0f) * p.noiseStrength;
+			}
+			return quantize(sampleClamp(src, u + du, v + dv), p.watercolorLevels).withAlpha(1.0f);
+		});
+	}
+
+	void magnifier(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		shade(src, dst, p, [&](float u, float v) {
+			const float dx = u - p.mouseX, dy = v - p.mouseY;
+			if (std::sqrt(dx * dx + dy * dy) < p.radius) {
+				u = p.mouseX + dx / p.zoom;
+				v = p.mouseY + dy / p.zoom;
+			}
+			if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) {
+				return CpuPixel::splat(0.0f);
+			}
+			return sampleClamp(src, u, v);
+		});
+	}
+
+	void pixelate(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		const float cellsX = std::ceil(src.width / p.pixelSize);
+		const float cellsY = std::ceil(src.height / p.pixelSize);
+		shade(src, dst, p, [&](const float u, const float v) {
+			return sampleClamp(src, (std::floor(u * cellsX) + 0.5f) / cellsX, (std::floor(v * cellsY) + 0.5f) / cellsY);
+		});
+	}
+
+	void sineWave(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		const float pi = 3.14159265f;
+		shade(src, dst, p, [&](const float u, const float v) {
+			const float x = u + p.power1 * std::sin(v * p.power2 * pi + p.time);
+			if (x < 0.0f || x > 1.0f) {
+				return CpuPixel::set(0.0f, 0.0f, 0.0f, 1.0f);
+			}
+			return sampleClamp(src, x, v);
+		});
+	}
+
+	// pp_fs_bloom_prefilter -> downsample x (levels - 1) -> weighted tent upsample -> pp_fs_bloom
+	void bloom(const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		const int levels = std::max(p.bloomLevels, 1);
+		m_bloom.resize(levels);
+		for (int i = 0; i < levels; i++) {
+			m_bloom[i].resize(std::max(1, src.width >> (i + 1)), std::max(1, src.height >> (i + 1)));
+		}
+
+		{
+			const float dx = 1.0f / src.width, dy = 1.0f / src.height;
+			run(m_bloom[0], [&](const float u, const float v) {
+				CpuPixel sum = extractBright(sampleClamp(src, u, v)) * 4.0f;
+				sum = sum + extractBright(sampleClamp(src, u - dx, v - dy));
+				sum = sum + extractBright(sampleClamp(src, u + dx, v - dy));
+				sum = sum + extractBright(sampleClamp(src, u - dx, v + dy));
+				sum = sum + extractBright(sampleClamp(src, u + dx, v + dy));
+				return sum * (1.0f / 8.0f);
+			});
+		}
+		for (int i = 1; i < levels; i++) {
+			const CpuImage& prev = m_bloom[i - 1];
+			const float dx = 0.5f / prev.width, dy = 0.5f / prev.height;
+			run(m_bloom[i], [&](const float u, const float v) {
+				CpuPixel sum = sampleClamp(prev, u, v) * 4.0f;
+				sum = sum + sampleClamp(prev, u - dx, v - dy);
+				sum = sum + sampleClamp(prev, u + dx, v - dy);
+				sum = sum + sampleClamp(prev, u - dx, v + dy);
+				sum = sum + sampleClamp(prev, u + dx, v + dy);
+				return sum * (1.0f / 8.0f);
+			});
+		}
+		for (int i = levels - 2; i >= 0; i--) {
+			CpuImage& target = m_bloom[i];
+			const CpuImage& next = m_bloom[i + 1];
+			const float dx = 1.0f / next.width, dy = 1.0f / next.height;
+			const float invW = 1.0f / target.width, invH = 1.0f / target.height;
+			// glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA): mix into the level in place
+			const float keep = 1.0f - p.bloomUpsampleWeight;
+			forEachTile(target.height, [&](const int y0, const int y1) {
+				for (int y = y0; y < y1; y++) {
+					const float v = (y + 0.5f) * invH;
+					float* out = target.row(y);
+					for (int x = 0; x < target.width; x++) {
+						const float u = (x + 0.5f) * invW;
+						CpuPixel sum = sampleClamp(next, u - dx * 2.0f, v) + sampleClamp(next, u + dx * 2.0f, v);
+						sum = sum + sampleClamp(next, u, v - dy * 2.0f) + sampleClamp(next, u, v + dy * 2.0f);
+						CpuPixel corners = sampleClamp(next, u - dx, v - dy) + sampleClamp(next, u + dx, v - dy);
+						corners = corners + sampleClamp(next, u - dx, v + dy) + sampleClamp(next, u + dx, v + dy);
+						(CpuPixel::load(out + x * 4) * keep + (sum + corners * 2.0f) * (p.bloomUpsampleWeight / 12.0f)).store(out + x * 4);
+					}
+				}
+			});
+		}
+
+		// 3x3 tent at +-1.5 bloom texels; R11G11B10F has no alpha channel, the composite reads 1.0 there
+		const float scale = p.bloomIntensity / 16.0f;
+		const CpuImage& blurred = m_bloom[0];
+		const float dx = 1.5f / blurred.width, dy = 1.5f / blurred.height;
+		shade(src, dst, p, [&](const float u, const float v) {
+			CpuPixel sum = sampleClamp(blurred, u, v) * 4.0f;
+			sum = sum + (sampleClamp(blurred, u - dx, v) + sampleClamp(blurred, u + dx, v)) * 2.0f;
+			sum = sum + (sampleClamp(blurred, u, v - dy) + sampleClamp(blurred, u, v + dy)) * 2.0f;
+			sum = sum + sampleClamp(blurred, u - dx, v - dy) + sampleClamp(blurred, u + dx, v - dy);
+			sum = sum + sampleClamp(blurred, u - dx, v + dy) + sampleClamp(blurred, u + dx, v + dy);
+			return sampleClamp(src, u, v) + sum.withAlpha(1.0f) * scale;
+		});
+	}
+
+	static CpuPixel extractBright(const CpuPixel c)
+	{
+		const float threshold = 0.75f;
+		return c * smoothstep(threshold - 0.1f, threshold + 0.15f, c.luminance());
+	}
+
+	// passthrough, tone mapping and quantization only depend on the pixel itself: whole rows at a time
+	void pointWise(const int effect, const CpuImage& src, CpuImage& dst, const CpuPostParams& p)
+	{
+		dst.resize(src.width, src.height);
+		const float levels = p.quantizeLevels;
+		forEachTile(dst.height, [&](const int y0, const int y1) {
+			for (int y = y0; y < y1; y++) {
+				const float* in = src.row(y);
+				float* out = dst.row(y);
+				const int count = dst.width * 4;
+				int i = 0;
+				if (effect != CPU_POST_TONEMAP && effect != CPU_POST_QUANTIZE) {
+					std::copy(in, in + count, out);
+					continue;
+				}
+#if CPU_POST_EFFECTS_AVX2
+				const __m256 rgb = _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1));
+				const __m256 one = _mm256_set1_ps(1.0f);
+				for (; i + 8 <= count; i += 8) {
+					const __m256 c = _mm256_loadu_ps(in + i);
+					__m256 r;
+					if (effect == CPU_POST_TONEMAP) {
+						r = _mm256_div_ps(c, _mm256_add_ps(c, one));
+					} else {
+						r = _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(c, _mm256_set1_ps(levels))), _mm256_set1_ps(1.0f / levels));
+					}
+					_mm256_storeu_ps(out + i, _mm256_blendv_ps(c, r, rgb));
+				}
+#endif
+				for (; i < count; i += 4) {
+					const CpuPixel c = CpuPixel::load(in + i);
+					const float alpha = in[i + 3];
+					if (effect == CPU_POST_TONEMAP) {
+						(c / (c + CpuPixel::splat(1.0f))).withAlpha(alpha).store(out + i);
+					} else {
+						quantize(c, levels).withAlpha(alpha).store(out + i);
+					}
+				}
+			}
+		});
+		applyComparison(src, dst, p);
+	}
+
+	// fn(firstRow, endRow) for every tile of TILE_ROWS rows, spread over the workers and this thread
+	void forEachTile(const int rows, const std::function<void(int, int)>& fn)
+	{
+		if (m_workers.empty() || rows <= TILE_ROWS) {
+			fn(0, rows);
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = &fn;
+			m_rows = rows;
+			m_nextTile = 0;
+			m_pending = (int)m_workers.size();
+			m_generation++;
+		}
+		m_wake.notify_all();
+		runTiles();
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_pending == 0; });
+		m_job = nullptr;
+	}
+
+	void runTiles()
+	{
+		for (;;) {
+			const int y0 = m_nextTile.fetch_add(1) * TILE_ROWS;
+			if (y0 >= m_rows) {
+				return;
+			}
+			(*m_job)(y0, std::min(y0 + TILE_ROWS, m_rows));
+		}
+	}
+
+	void workerLoop()
+	{
+		unsigned long long seen = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_quit || m_generation != seen; });
+				if (m_quit) {
+					return;
+				}
+				seen = m_generation;
+			}
+			runTiles();
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pending--;
+			}
+			m_done.notify_one();
+		}
+	}
+
+private:
+	std::vector<CpuImage> m_bloom;      // mip chain, level i = 1 / 2^(i+1) resolution
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const std::function<void(int, int)>* m_job = nullptr;
+	std::atomic<int> m_nextTile{ 0 };
+	int m_rows = 0;
+	unsigned long long m_generation = 0;
+	int m_pending = 0;
+	bool m_quit = false;
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+// CPU scope tracing, exported as Chrome trace_event JSON (open in chrome://tracing or ui.perfetto.dev).
+//
+//   void load() { TRACE_SCOPE("Model::load"); ... }
+//   CpuTrace::dump("cpu_trace.json");             // on demand, or once before exit
+//
+// Every thread writes into its own fixed-size ring, so recording takes no lock; old events
+// are overwritten once a ring is full. Tracing is off until CpuTrace::setEnabled(true) (the GUI
+// checkbox) or the environment variable CPU_TRACE=1; while off, a scope is one relaxed atomic
+// load. Define CPU_TRACE_ENABLED to 0 to compile the scopes out entirely.
+//
+// Scope names must outlive the dump (string literals).
+
+#ifndef CPU_TRACE_ENABLED
+#define CPU_TRACE_ENABLED 1
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class CpuTrace
+{
+public:
+	static const size_t RING_SIZE = 1 << 16; // events per thread
+
+	struct Event
+	{
+		const char* name;
+		long long beginUs;
+		long long durationUs;
+	};
+
+	struct ThreadBuffer
+	{
+		std::vector<Event> events;
+		std::atomic<size_t> written;
+		unsigned int tid;
+
+		ThreadBuffer(const unsigned int id) : events(RING_SIZE), written(0), tid(id) {}
+	};
+
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name) : m_name(name), m_beginUs(CpuTrace::enabled() ? CpuTrace::nowUs() : -1) {}
+		~Scope()
+		{
+			if (m_beginUs >= 0) {
+				CpuTrace::record(m_name, m_beginUs, CpuTrace::nowUs() - m_beginUs);
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* m_name;
+		long long m_beginUs;
+	};
+
+public:
+	static bool enabled() { return enabledFlag().load(std::memory_order_relaxed); }
+	static void setEnabled(const bool enabled) { enabledFlag().store(enabled, std::memory_order_relaxed); }
+
+	static long long nowUs()
+	{
+		static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+	}
+
+	static void record(const char* name, const long long beginUs, const long long durationUs)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		const size_t n = buffer.written.load(std::memory_order_relaxed);
+		Event& e = buffer.events[n % RING_SIZE];
+		e.name = name;
+		e.beginUs = beginUs;
+		e.durationUs = durationUs;
+		buffer.written.store(n + 1, std::memory_order_release);
+	}
+
+	// Writes every thread's ring. Safe to call while other threads keep recording, although
+	// an event that is overwritten during the dump may come out torn.
+	static bool dump(const char* path)
+	{
+		FILE* file = std::fopen(path, "w");
+		if (file == nullptr) {
+			std::fprintf(stderr, "CpuTrace: cannot open %s\n", path);
+			return false;
+		}
+
+		std::fprintf(file, "{\"traceEvents\":[\n");
+		bool first = true;
+		std::lock_guard<std::mutex> lock(registryMutex());
+		for (const std::shared_ptr<ThreadBuffer>& buffer : registry()) {
+			const size_t written = buffer->written.load(std::memory_order_acquire);
+			const size_t count = (written < RING_SIZE) ? written : (size_t)RING_SIZE;
+			for (size_t i = written - count; i < written; i++) {
+				const Event& e = buffer->events[i % RING_SIZE];
+				std::fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+				writeEscaped(file, e.name);
+				std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld}", buffer->tid, e.beginUs, e.durationUs);
+				first = false;
+			}
+		}
+		std::fprintf(file, "\n]}\n");
+		std::fclose(file);
+		std::printf("CpuTrace: wrote %s\n", path);
+		return true;
+	}
+
+private:
+	static std::atomic<bool>& enabledFlag()
+	{
+		static std::atomic<bool> flag(enabledFromEnvironment());
+		return flag;
+	}
+
+	static bool enabledFromEnvironment()
+	{
+		const char* value = std::getenv("CPU_TRACE");
+		return value != nullptr && value[0] != '\0' && value[0] != '0';
+	}
+
+	static std::mutex& registryMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	// buffers are owned by the registry so that events of finished threads survive until the dump
+	static std::vector<std::shared_ptr<ThreadBuffer>>& registry()
+	{
+		static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+		return buffers;
+	}
+
+	static ThreadBuffer& threadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (buffer == nullptr) {
+			std::lock_guard<std::mutex> lock(registryMutex());
+			registry().push_back(std::make_shared<ThreadBuffer>((unsigned int)registry().size()));
+			buffer = registry().back().get();
+		}
+		return *buffer;
+	}
+
+	static void writeEscaped(FILE* file, const char* s)
+	{
+		for (; *s != '\0'; s++) {
+			if (*s == '"' || *s == '\\') {
+				std::fputc('\\', file);
+			}
+			std::fputc(*s, file);
+		}
+	}
+};
+
+#define CPU_TRACE_CONCAT_INNER(a, b) a##b
+#define CPU_TRACE_CONCAT(a, b) CPU_TRACE_CONCAT_INNER(a, b)
+
+#if CPU_TRACE_ENABLED
+#define TRACE_SCOPE(name) CpuTrace::Scope CPU_TRACE_CONCAT(cpuTraceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,545 @@
+#pragma once
+
+// Asynchronous frame capture to a PNG sequence or a raw Y4M video, without stalling the GPU.
+//
+//   static FrameCapture frameCapture;
+//   frameCapture.drawImGui();                      // format, start / stop, statistics
+//   frameCapture.captureFrame(width, height);      // every frame, right before glfwSwapBuffers
+//   frameCapture.release();                        // before the context is destroyed
+//
+// glReadPixels goes into a ring of GL_PIXEL_PACK_BUFFERs followed by a fence, so it returns at
+// once. The fences are polled on later frames (the data is usually ready 2-3 frames later) and
+// only a signaled buffer is mapped. The mapped pointer is handed to a writer thread, which copies
+// it into one of at most MAX_QUEUED frame buffers and encodes from there; the pack buffer is
+// unmapped again on the next frame. A frame is dropped and counted, never waited for, when its
+// ring slot is still busy or all frame buffers are waiting to be written, so memory stays bounded
+// and the render loop does not block. In a Y4M file a dropped frame repeats the previous one, so
+// the video keeps its timing.
+//
+// PNGs are written uncompressed (stored deflate blocks, no zlib needed), RGB without alpha. Y4M is
+// 4:2:0 with full range BT.601 (C420jpeg), which ffmpeg and VLC read directly.
+
+#include <glad/glad.h>
+#include "imgui.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameCapture
+{
+public:
+	enum Format { PNG = 0, Y4M = 1 };
+
+	static const int RING = 4;            // pack buffers in flight
+	static const int MAX_QUEUED = 8;      // frames copied out but not written yet
+
+public:
+	FrameCapture() {}
+
+	~FrameCapture()
+	{
+		stopWriter();
+	}
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+
+	// basePath + "_000000.png" ... or basePath + ".y4m"
+	bool start(const std::string& basePath, const Format format, const int fps = 60)
+	{
+		if (m_active) {
+			return false;
+		}
+		m_format = format;
+		m_fps = fps;
+		m_path = basePath + (format == PNG ? "_%06lld.png" : ".y4m");
+		if (format == Y4M) {
+			m_file = std::fopen(m_path.c_str(), "wb");
+			if (!m_file) {
+				return false;
+			}
+		}
+		m_frameIndex = 0;
+		m_lastWritten = -1;
+		m_yuv.clear();
+		m_videoWidth = m_videoHeight = 0;
+		m_written = 0;
+		m_dropped = 0;
+		m_avgMs = m_maxMs = 0.0;
+		m_quit = false;
+		m_writer = std::thread(&FrameCapture::writerLoop, this);
+		m_active = true;
+		return true;
+	}
+
+	// waits for the readbacks still in flight and for the writer to finish the queue
+	void stop()
+	{
+		if (!m_active) {
+			return;
+		}
+		poll(true);
+		stopWriter();
+		unmapCopied();
+		if (m_file) {
+			std::fclose(m_file);
+			m_file = nullptr;
+		}
+		m_active = false;
+	}
+
+	// call while the GL context is still current (a global instance outlives it)
+	void release()
+	{
+		stop();
+		for (Slot& s : m_slots) {
+			if (s.fence) {
+				glDeleteSync(s.fence);
+				s.fence = nullptr;
+			}
+			if (s.pbo) {
+				glDeleteBuffers(1, &s.pbo);
+				s.pbo = 0;
+			}
+			s.capacity = 0;
+			s.state = Slot::FREE;
+		}
+	}
+
+	bool active() const { return m_active; }
+	long long written() const { return m_written; }
+	long long dropped() const { return m_dropped; }
+
+	// reads the default framebuffer (width x height) of the frame that was just drawn
+	void captureFrame(const int width, const int height)
+	{
+		if (!m_active || width <= 0 || height <= 0) {
+			return;
+		}
+		const auto start = std::chrono::steady_clock::now();
+
+		unmapCopied();
+		poll(false);
+
+		Slot& s = m_slots[m_next];
+		if (s.state != Slot::FREE) {
+			m_dropped++; // the ring is full: the writer or the GPU is behind
+		} else {
+			const size_t bytes = (size_t)width * height * 4;
+			if (s.pbo == 0) {
+				glGenBuffers(1, &s.pbo);
+			}
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+			if (s.capacity < bytes) {
+				glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_READ);
+				s.capacity = bytes;
+			}
+			GLint readFramebuffer = 0;
+			glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			s.width = width;
+			s.height = height;
+			s.frame = m_frameIndex;
+			s.state = Slot::READING;
+			m_next = (m_next + 1) % RING;
+		}
+		m_frameIndex++;
+
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		m_avgMs = (m_frameIndex == 1) ? ms : m_avgMs * 0.95 + ms * 0.05;
+		m_maxMs = (ms > m_maxMs) ? ms : m_maxMs;
+	}
+
+	// format, start / stop and the capture statistics
+	void drawImGui()
+	{
+		if (!m_active) {
+			ImGui::Combo("Capture format", &m_formatIndex, "PNG sequence\0Y4M video\0");
+			if (m_formatIndex == Y4M) {
+				ImGui::SliderInt("Capture fps", &m_fpsSetting, 1, 240);
+			}
+			if (ImGui::Button("Start capture")) {
+				char name[64];
+				const std::time_t now = std::time(nullptr);
+				std::strftime(name, sizeof(name), "capture_%Y%m%d_%H%M%S", std::localtime(&now));
+				start(name, (Format)m_formatIndex, m_fpsSetting);
+			}
+		} else {
+			if (ImGui::Button("Stop capture")) {
+				stop();
+			}
+			ImGui::SameLine();
+			ImGui::TextUnformatted(m_path.c_str());
+		}
+		int queued = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			queued = (int)m_queue.size();
+		}
+		ImGui::Text("written %lld, dropped %lld, queued %d", m_written.load(), m_dropped.load(), queued);
+		ImGui::Text("capture cost: avg %.3f ms, max %.3f ms", m_avgMs, m_maxMs);
+	}
+
+private:
+	struct Slot
+	{
+		enum State { FREE, READING, MAPPED };
+
+		GLuint pbo = 0;
+		GLsync fence = nullptr;
+		size_t capacity = 0;
+		int width = 0;
+		int height = 0;
+		long long frame = 0;
+		State state = FREE;
+	};
+
+	struct Job
+	{
+		int slot;
+		const unsigned char* pixels;
+		int width;
+		int height;
+		long long frame;
+	};
+
+	struct Frame
+	{
+		std::vector<unsigned char> rgba; // top row first
+		int width;
+		int height;
+		long long frame;
+	};
+
+	// maps finished readbacks oldest first and hands them to the writer; wait = block on the fences
+	void poll(const bool wait)
+	{
+		for (int k = 0; k < RING; k++) {
+			const int index = (m_next + k) % RING;
+			Slot& s = m_slots[index];
+			if (s.state != Slot::READING) {
+				continue;
+			}
+			const GLenum status = glClientWaitSync(s.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+			if (status == GL_TIMEOUT_EXPIRED) {
+				return; // keep the frames in order
+			}
+			glDeleteSync(s.fence);
+			s.fence = nullptr;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+			const void* pixels = (status == GL_WAIT_FAILED) ? nullptr :
+				glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)s.width * s.height * 4, GL_MAP_READ_BIT);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			if (!pixels) {
+				s.state = Slot::FREE;
+				m_dropped++;
+				continue;
+			}
+			s.state = Slot::MAPPED;
+			m_copied[index] = false;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_jobs.push_back({ index, (const unsigned char*)pixels, s.width, s.height, s.frame });
+			}
+			m_wake.notify_one();
+		}
+	}
+
+	void unmapCopied()
+	{
+		for (int i = 0; i < RING; i++) {
+			Slot& s = m_slots[i];
+			if (s.state == Slot::MAPPED && m_copied[i]) {
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+				s.state = Slot::FREE;
+			}
+		}
+	}
+
+	void stopWriter()
+	{
+		if (!m_writer.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+		m_writer.join();
+	}
+
+	// copies mapped buffers out first (they hold up the ring), encodes queued frames in between
+	void writerLoop()
+	{
+		for (;;) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() { return m_quit || !m_jobs.empty() || !m_queue.empty(); });
+			if (!m_jobs.empty()) {
+				const Job job = m_jobs.front();
+				m_jobs.pop_front();
+				const bool room = (int)m_queue.size() + m_encoding < MAX_QUEUED;
+				std::vector<unsigned char> buffer;
+				if (room && !m_free.empty()) {
+					buffer = std::move(m_free.back());
+					m_free.pop_back();
+				}
+				lock.unlock();
+
+				if (room) {
+					// GL rows are bottom to top
+					const size_t rowBytes = (size_t)job.width * 4;
+					buffer.resize(rowBytes * job.height);
+					for (int y = 0; y < job.height; y++) {
+						std::memcpy(&buffer[(size_t)y * rowBytes], job.pixels + (size_t)(job.height - 1 - y) * rowBytes, rowBytes);
+					}
+				}
+				m_copied[job.slot] = true;
+
+				lock.lock();
+				if (room) {
+					m_queue.push_back({ std::move(buffer), job.width, job.height, job.frame });
+				} else {
+					m_dropped++;
+				}
+				continue;
+			}
+			if (!m_queue.empty()) {
+				Frame frame = std::move(m_queue.front());
+				m_queue.pop_front();
+				m_encoding = 1;
+				lock.unlock();
+
+				if (m_format == PNG ? writePng(frame) : writeY4m(frame)) {
+					m_written++;
+				} else {
+					m_dropped++;
+				}
+
+				lock.lock();
+				m_encoding = 0;
+				m_free.push_back(std::move(frame.rgba));
+				continue;
+			}
+			if (m_quit) {
+				return;
+			}
+		}
+	}
+
+	bool writePng(const Frame& frame)
+	{
+		char path[512];
+		std::snprintf(path, sizeof(path), m_path.c_str(), frame.frame);
+		FILE* file = std::fopen(path, "wb");
+		if (!file) {
+			return false;
+		}
+
+		// zlib stream of stored deflate blocks over (filter byte 0 + RGB row) for every row
+		const size_t rowBytes = (size_t)frame.width * 3 + 1;
+		const size_t rawBytes = rowBytes * frame.height;
+		const size_t blocks = (rawBytes + 65534) / 65535;
+		m_raw.resize(rawBytes);
+		for (int y = 0; y < frame.height; y++) {
+			unsigned char* out = &m_raw[(size_t)y * rowBytes];
+			const unsigned char* in = &frame.rgba[(size_t)y * frame.width * 4];
+			*out++ = 0;
+			for (int x = 0; x < frame.width; x++, in += 4) {
+				*out++ = in[0];
+				*out++ = in[1];
+				*out++ = in[2];
+			}
+		}
+		m_png.clear();
+		m_png.reserve(rawBytes + blocks * 5 + 6);
+		m_png.push_back(0x78);
+		m_png.push_back(0x01);
+		for (size_t offset = 0; offset < rawBytes; offset += 65535) {
+			const size_t length = (rawBytes - offset < 65535) ? rawBytes - offset : 65535;
+			m_png.push_back(offset + length == rawBytes ? 1 : 0);
+			m_png.push_back((unsigned char)(length & 0xFF));
+			m_png.push_back((unsigned char)(length >> 8));
+			m_png.push_back((unsigned char)(~length & 0xFF));
+			m_png.push_back((unsigned char)((~length >> 8) & 0xFF));
+			m_png.insert(m_png.end(), m_raw.begin() + offset, m_raw.begin() + offset + length);
+		}
+		uint32_t a = 1, b = 0;
+		for (size_t i = 0; i < rawBytes; i++) {
+			a = (a + m_raw[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		putBigEndian(m_png, (b << 16) | a);
+
+		static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		unsigned char header[13] = {};
+		putBigEndian(header, (uint32_t)frame.width);
+		putBigEndian(header + 4, (uint32_t)frame.height);
+		header[8] = 8;  // bits per channel
+		header[9] = 2;  // RGB
+		bool ok = std::fwrite(signature, 1, sizeof(signature), file) == sizeof(signature);
+		ok = ok && writePngChunk(file, "IHDR", header, sizeof(header));
+		ok = ok && writePngChunk(file, "IDAT", m_png.data(), m_png.size());
+		ok = ok && writePngChunk(file, "IEND", nullptr, 0);
+		std::fclose(file);
+		return ok;
+	}
+
+	static bool writePngChunk(FILE* file, const char* type, const unsigned char* data, const size_t size)
+	{
+		unsigned char length[4];
+		putBigEndian(length, (uint32_t)size);
+		uint32_t crc = crc32(0xFFFFFFFFu, (const unsigned char*)type, 4);
+		crc = crc32(crc, data, size) ^ 0xFFFFFFFFu;
+		unsigned char crcBytes[4];
+		putBigEndian(crcBytes, crc);
+		return std::fwrite(length, 1, 4, file) == 4 && std::fwrite(type, 1, 4, file) == 4 &&
+			(size == 0 || std::fwrite(data, 1, size, file) == size) && std::fwrite(crcBytes, 1, 4, file) == 4;
+	}
+
+	static uint32_t crc32(uint32_t crc, const unsigned char* data, const size_t size)
+	{
+		static uint32_t table[256];
+		static std::once_flag once;
+		std::call_once(once, []() {
+			for (uint32_t n = 0; n < 256; n++) {
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++) {
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				}
+				table[n] = c;
+			}
+		});
+		for (size_t i = 0; i < size; i++) {
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+		return crc;
+	}
+
+	static void putBigEndian(unsigned char* out, const uint32_t v)
+	{
+		out[0] = (unsigned char)(v >> 24);
+		out[1] = (unsigned char)(v >> 16);
+		out[2] = (unsigned char)(v >> 8);
+		out[3] = (unsigned char)v;
+	}
+
+	static void putBigEndian(std::vector<unsigned char>& out, const uint32_t v)
+	{
+		unsigned char bytes[4];
+		putBigEndian(bytes, v);
+		out.insert(out.end(), bytes, bytes + 4);
+	}
+
+	bool writeY4m(const Frame& frame)
+	{
+		if (m_videoWidth == 0) {
+			m_videoWidth = frame.width;
+			m_videoHeight = frame.height;
+			std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", m_videoWidth, m_videoHeight, m_fps);
+		} else if (frame.width != m_videoWidth || frame.height != m_videoHeight) {
+			return false; // the size of a Y4M stream is fixed, frames after a resize are dropped
+		}
+
+		// repeat the last frame for every dropped one in between
+		if (!m_yuv.empty()) {
+			for (long long i = m_lastWritten + 1; i < frame.frame; i++) {
+				std::fputs("FRAME\n", m_file);
+				std::fwrite(m_yuv.data(), 1, m_yuv.size(), m_file);
+			}
+		}
+
+		const int w = frame.width, h = frame.height;
+		const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+		m_yuv.resize((size_t)w * h + (size_t)cw * ch * 2);
+		unsigned char* yPlane = m_yuv.data();
+		unsigned char* uPlane = yPlane + (size_t)w * h;
+		unsigned char* vPlane = uPlane + (size_t)cw * ch;
+		// full range BT.601 in 16.16 fixed point
+		for (int y = 0; y < h; y++) {
+			const unsigned char* in = &frame.rgba[(size_t)y * w * 4];
+			for (int x = 0; x < w; x++, in += 4) {
+				yPlane[(size_t)y * w + x] = (unsigned char)((19595 * in[0] + 38470 * in[1] + 7471 * in[2] + 32768) >> 16);
+			}
+		}
+		for (int cy = 0; cy < ch; cy++) {
+			for (int cx = 0; cx < cw; cx++) {
+				int r = 0, g = 0, b = 0, n = 0;
+				for (int dy = 0; dy < 2; dy++) {
+					for (int dx = 0; dx < 2; dx++) {
+						const int x = cx * 2 + dx, y = cy * 2 + dy;
+						if (x < w && y < h) {
+							const unsigned char* p = &frame.rgba[((size_t)y * w + x) * 4];
+							r += p[0];
+							g += p[1];
+							b += p[2];
+							n++;
+						}
+					}
+				}
+				r /= n;
+				g /= n;
+				b /= n;
+				const int u = (-11059 * r - 21709 * g + 32768 * b + (128 << 16) + 32768) >> 16;
+				const int v = (32768 * r - 27439 * g - 5329 * b + (128 << 16) + 32768) >> 16;
+				uPlane[(size_t)cy * cw + cx] = (unsigned char)(u > 255 ? 255 : u);
+				vPlane[(size_t)cy * cw + cx] = (unsigned char)(v > 255 ? 255 : v);
+			}
+		}
+		std::fputs("FRAME\n", m_file);
+		const bool ok = std::fwrite(m_yuv.data(), 1, m_yuv.size(), m_file) == m_yuv.size();
+		m_lastWritten = frame.frame;
+		return ok;
+	}
+
+private:
+	Slot m_slots[RING];
+	std::atomic<bool> m_copied[RING] = {};
+	int m_next = 0;                     // oldest slot, the next one to read into
+	long long m_frameIndex = 0;
+	bool m_active = false;
+	double m_avgMs = 0.0;
+	double m_maxMs = 0.0;
+
+	Format m_format = PNG;
+	int m_fps = 60;
+	std::string m_path;                 // printf pattern for PNG, file name for Y4M
+	FILE* m_file = nullptr;
+	int m_formatIndex = PNG;            // GUI selection
+	int m_fpsSetting = 60;
+
+	// writer thread side
+	std::thread m_writer;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<Job> m_jobs;
+	std::deque<Frame> m_queue;
+	std::vector<std::vector<unsigned char>> m_free;
+	int m_encoding = 0;
+	bool m_quit = false;
+	std::atomic<long long> m_written{ 0 };
+	std::atomic<long long> m_dropped{ 0 };
+	std::vector<unsigned char> m_raw;
+	std::vector<unsigned char> m_png;
+	std::vector<unsigned char> m_yuv;
+	long long m_lastWritten = -1;
+	int m_videoWidth = 0;
+	int m_videoHeight = 0;
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+// Sort-key draw queue with redundant-bind elision.
+//
+// Every draw gets a 64-bit key, most significant field first:
+//
+//   [63..56] program slot   [55..48] VAO slot   [47..32] unused   [31..0] view depth (float bits)
+//
+// so a sorted queue changes program as rarely as possible, then VAO, and goes front to back inside
+// a run. Only state that submit() actually binds belongs above the depth: anything else (e.g. the
+// material, which the shader reads per draw from the material table) would only break up the
+// front-to-back order and cost early-z without saving a bind. Keys are sorted with an LSD radix
+// sort (8 passes of 8 bits, passes where every key has the same digit are skipped).
+//
+//   queue.clear();
+//   queue.push(program, vao, depth, drawIndex);
+//   queue.sort();
+//   queue.submit(state, [&](const uint32_t* draws, size_t count) { ... one batch ... });
+//
+// submit() binds program and VAO through GlStateCache and hands the caller each run of draws that
+// share both, which is what a single glMultiDrawElementsIndirect can cover.
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Remembers the last program / VAO / texture per unit and skips binds that would change nothing.
+// invalidate() must be called whenever GL state may have been changed behind its back (e.g. once
+// per frame when other passes bind directly).
+class GlStateCache
+{
+public:
+	static const int MAX_TEXTURE_UNITS = 16;
+
+	GlStateCache() { invalidate(); }
+
+	void invalidate()
+	{
+		m_program = INVALID;
+		m_vao = INVALID;
+		m_activeUnit = INVALID;
+		for (int i = 0; i < MAX_TEXTURE_UNITS; i++) {
+			m_textures[i] = INVALID;
+		}
+	}
+
+	void useProgram(const GLuint program)
+	{
+		if (program == m_program) { m_elided++; return; }
+		glUseProgram(program);
+		m_program = program;
+		m_issued++;
+	}
+
+	void bindVertexArray(const GLuint vao)
+	{
+		if (vao == m_vao) { m_elided++; return; }
+		glBindVertexArray(vao);
+		m_vao = vao;
+		m_issued++;
+	}
+
+	void bindTexture(const GLuint unit, const GLenum target, const GLuint texture)
+	{
+		// the target is not tracked: a unit is expected to hold one kind of texture
+		if (unit < MAX_TEXTURE_UNITS && m_textures[unit] == texture) { m_elided++; return; }
+		if (unit != m_activeUnit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			m_activeUnit = unit;
+		}
+		glBindTexture(target, texture);
+		if (unit < MAX_TEXTURE_UNITS) {
+			m_textures[unit] = texture;
+		}
+		m_issued++;
+	}
+
+	void resetStats() { m_issued = m_elided = 0; }
+	int issued() const { return m_issued; }
+	int elided() const { return m_elided; }
+
+private:
+	static const GLuint INVALID = 0xFFFFFFFFu;
+
+	GLuint m_program;
+	GLuint m_vao;
+	GLuint m_activeUnit;
+	GLuint m_textures[MAX_TEXTURE_UNITS];
+	int m_issued = 0;
+	int m_elided = 0;
+};
+
+class RenderQueue
+{
+public:
+	struct Item
+	{
+		uint64_t key;
+		uint32_t draw;        // caller's draw index (e.g. into an indirect command array)
+		uint8_t programSlot;
+		uint8_t vaoSlot;
+	};
+
+	void clear()
+	{
+		m_items.clear();
+	}
+
+	// depth: view distance, negative values are clamped to 0. With sortByState off the key is the
+	// depth alone, i.e. plain front-to-back order.
+	void push(const GLuint program, const GLuint vao, const float depth, const uint32_t draw)
+	{
+		Item item;
+		item.programSlot = slotOf(m_programs, program);
+		item.vaoSlot = slotOf(m_vaos, vao);
+		item.draw = draw;
+
+		// positive IEEE floats order the same as their bit patterns
+		const float d = depth > 0.0f ? depth : 0.0f;
+		uint32_t depthBits;
+		std::memcpy(&depthBits, &d, sizeof(depthBits));
+
+		item.key = depthBits;
+		if (m_sortByState) {
+			item.key |= ((uint64_t)item.programSlot << 56) | ((uint64_t)item.vaoSlot << 48);
+		}
+		m_items.push_back(item);
+	}
+
+	void sort()
+	{
+		const size_t n = m_items.size();
+		m_scratch.resize(n);
+		Item* src = m_items.data();
+		Item* dst = m_scratch.data();
+		for (int shift = 0; shift < 64; shift += 8) {
+			size_t count[256] = {};
+			for (size_t i = 0; i < n; i++) {
+				count[(src[i].key >> shift) & 0xFF]++;
+			}
+			if (n == 0 || count[(src[0].key >> shift) & 0xFF] == n) {
+				continue; // every key has the same digit, the pass would not move anything
+			}
+			size_t offset = 0;
+			for (int d = 0; d < 256; d++) {
+				const size_t c = count[d];
+				count[d] = offset;
+				offset += c;
+			}
+			for (size_t i = 0; i < n; i++) {
+				dst[count[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			std::swap(src, dst);
+		}
+		if (src != m_items.data()) {
+			m_items.swap(m_scratch);
+		}
+	}
+
+	// Binds program / VAO per run and calls drawBatch(const uint32_t* draws, size_t count) for every
+	// run of consecutive items that share both.
+	template <class DrawBatch>
+	void submit(GlStateCache& state, DrawBatch drawBatch)
+	{
+		m_batches = 0;
+		m_batchDraws.clear();
+		size_t i = 0;
+		while (i < m_items.size()) {
+			const Item& first = m_items[i];
+			state.useProgram(m_programs[first.programSlot]);
+			state.bindVertexArray(m_vaos[first.vaoSlot]);
+
+			m_batchDraws.clear();
+			for (; i < m_items.size() && m_items[i].programSlot == first.programSlot && m_items[i].vaoSlot == first.vaoSlot; i++) {
+				m_batchDraws.push_back(m_items[i].draw);
+			}
+			drawBatch(m_batchDraws.data(), m_batchDraws.size());
+			m_batches++;
+		}
+	}
+
+	void setSortByState(const bool enabled) { m_sortByState = enabled; }
+	bool sortByState() const { return m_sortByState; }
+	const std::vector<Item>& items() const { return m_items; }
+	int batches() const { return m_batches; }
+
+private:
+	static uint8_t slotOf(std::vector<GLuint>& slots, const GLuint handle)
+	{
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i] == handle) {
+				return (uint8_t)i;
+			}
+		}
+		// slots are only ever appended, so a key stays stable across frames
+		slots.push_back(handle);
+		return (uint8_t)(slots.size() - 1);
+	}
+
+	std::vector<Item> m_items;
+	std::vector<Item> m_scratch;
+	std::vector<uint32_t> m_batchDraws;
+	std::vector<GLuint> m_programs; // slot -> GL name
+	std::vector<GLuint> m_vaos;
+	bool m_sortByState = true;
+	int m_batches = 0;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+// Pooled color render targets for chained full-screen passes.
+//
+// Targets are keyed by (allocated size, format). Requested sizes are rounded up to
+// SIZE_GRANULARITY so that dragging a window edge keeps hitting the same targets instead of
+// reallocating every frame; callers render into the bottom-left width x height region and scale
+// their UVs by uvScale(). A target released this frame is handed out again to the next acquire of
+// the same key, which is what makes a chain ping-pong between two targets.
+//
+//   RenderTarget* rt = pool.acquire(w, h, GL_R11F_G11F_B10F);
+//   ... render into rt->fbo, later sample rt->texture ...
+//   pool.release(rt);
+//   pool.endFrame();    // once per frame, frees targets that have not been used for a while
+//   pool.releaseAll();  // before the context is destroyed
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <vector>
+
+struct RenderTarget
+{
+	GLuint fbo = 0;
+	GLuint texture = 0;
+	int width = 0;   // allocated
+	int height = 0;
+	GLenum format = 0;
+	int usedWidth = 0;  // requested by the current owner
+	int usedHeight = 0;
+	bool inUse = false;
+	unsigned long long lastUsedFrame = 0;
+
+	float uvScaleX() const { return (float)usedWidth / (float)width; }
+	float uvScaleY() const { return (float)usedHeight / (float)height; }
+};
+
+class RenderTargetPool
+{
+public:
+	static const int SIZE_GRANULARITY = 128;
+	static const unsigned long long KEEP_FRAMES = 120; // free targets unused this long are deleted
+
+	static int roundUp(const int size)
+	{
+		return ((size + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY) * SIZE_GRANULARITY;
+	}
+
+	RenderTargetPool() {}
+	RenderTargetPool(const RenderTargetPool&) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+	RenderTarget* acquire(const int width, const int height, const GLenum format)
+	{
+		const int w = roundUp(width), h = roundUp(height);
+		for (std::unique_ptr<RenderTarget>& t : m_targets) {
+			if (!t->inUse && t->width == w && t->height == h && t->format == format) {
+				return use(*t, width, height);
+			}
+		}
+
+		std::unique_ptr<RenderTarget> t(new RenderTarget());
+		t->width = w;
+		t->height = h;
+		t->format = format;
+		glGenTextures(1, &t->texture);
+		glBindTexture(GL_TEXTURE_2D, t->texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, format, w, h);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glGenFramebuffers(1, &t->fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, t->fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t->texture, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		m_allocations++;
+
+		m_targets.push_back(std::move(t));
+		return use(*m_targets.back(), width, height);
+	}
+
+	void release(RenderTarget* target)
+	{
+		if (target) {
+			target->inUse = false;
+		}
+	}
+
+	void endFrame()
+	{
+		for (size_t i = 0; i < m_targets.size();) {
+			RenderTarget& t = *m_targets[i];
+			if (!t.inUse && m_frame - t.lastUsedFrame > KEEP_FRAMES) {
+				destroy(t);
+				m_targets.erase(m_targets.begin() + i);
+			}
+			else {
+				i++;
+			}
+		}
+		m_frame++;
+	}
+
+	void releaseAll()
+	{
+		for (std::unique_ptr<RenderTarget>& t : m_targets) {
+			destroy(*t);
+		}
+		m_targets.clear();
+	}
+
+	size_t size() const { return m_targets.size(); }
+	int allocations() const { return m_allocations; } // total since start, for spotting churn
+
+private:
+	RenderTarget* use(RenderTarget& t, const int width, const int height)
+	{
+		t.inUse = true;
+		t.usedWidth = width;
+		t.usedHeight = height;
+		t.lastUsedFrame = m_frame;
+		return &t;
+	}
+
+	static void destroy(RenderTarget& t)
+	{
+		glDeleteFramebuffers(1, &t.fbo);
+		glDeleteTextures(1, &t.texture);
+		t.fbo = t.texture = 0;
+	}
+
+	std::vector<std::unique_ptr<RenderTarget>> m_targets;
+	unsigned long long m_frame = 0;
+	int m_allocations = 0;
+};
@@ -0,0 +1,248 @@
+#pragma once
+
+// Bounding volume hierarchy over per-mesh world-space AABBs, used for CPU frustum culling.
+//
+//   SceneBVH bvh;
+//   bvh.build(worldBoxes);                              // once, after the model matrix is known
+//   SceneBVH::extractFrustumPlanes(P * V, planes);
+//   bvh.cullFrustum(planes, eye, visible);              // every frame, visible = front-to-back mesh indices
+//
+// The box/plane test runs 4 planes at a time with SSE when available (define SCENE_BVH_NO_SIMD to
+// force the scalar path). A node that is completely inside the frustum emits its whole subtree
+// without testing it any further.
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if !defined(SCENE_BVH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SCENE_BVH_SSE 1
+#include <xmmintrin.h>
+#else
+#define SCENE_BVH_SSE 0
+#endif
+
+struct BvhAabb
+{
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+class SceneBVH
+{
+public:
+	static const int MAX_LEAF_SIZE = 4;
+
+	struct Node
+	{
+		BvhAabb box;
+		uint32_t first;   // leaf: first entry in m_items, inner: index of the left child (right = first + 1)
+		uint32_t count;   // 0 for inner nodes
+	};
+
+	enum class Result { OUTSIDE, INTERSECT, INSIDE };
+
+public:
+	void build(const std::vector<BvhAabb>& boxes)
+	{
+		m_boxes = boxes;
+		m_items.resize(boxes.size());
+		for (size_t i = 0; i < boxes.size(); i++) {
+			m_items[i] = (uint32_t)i;
+		}
+		m_nodes.clear();
+		if (boxes.empty()) {
+			return;
+		}
+		m_nodes.reserve(boxes.size() * 2);
+		m_nodes.push_back(Node());
+		subdivide(0, 0, (uint32_t)boxes.size());
+	}
+
+	// Gribb-Hartmann: planes of clip-space -w <= x,y,z <= w, normals point inwards
+	static void extractFrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6])
+	{
+		const glm::mat4 m = glm::transpose(viewProj);
+		planes[0] = m[3] + m[0]; // left
+		planes[1] = m[3] - m[0]; // right
+		planes[2] = m[3] + m[1]; // bottom
+		planes[3] = m[3] - m[1]; // top
+		planes[4] = m[3] + m[2]; // near
+		planes[5] = m[3] - m[2]; // far
+		for (int i = 0; i < 6; i++) {
+			planes[i] = planes[i] / glm::length(glm::vec3(planes[i]));
+		}
+	}
+
+	// visible gets the indices (into the boxes passed to build) of every box that touches the frustum,
+	// sorted by distance from eye, nearest first
+	void cullFrustum(const glm::vec4 planes[6], const glm::vec3& eye, std::vector<uint32_t>& visible) const
+	{
+		visible.clear();
+		if (m_nodes.empty()) {
+			return;
+		}
+		FrustumSoA f;
+		for (int i = 0; i < 8; i++) {
+			const glm::vec4 p = (i < 6) ? planes[i] : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // padding planes never reject
+			f.nx[i] = p.x; f.ny[i] = p.y; f.nz[i] = p.z; f.d[i] = p.w;
+		}
+
+		uint32_t stack[64];
+		int top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const Node& node = m_nodes[stack[--top]];
+			const Result r = testBox(f, node.box);
+			if (r == Result::OUTSIDE) {
+				continue;
+			}
+			if (r == Result::INSIDE) {
+				appendSubtree(node, visible);
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = 0; i < node.count; i++) {
+					const uint32_t item = m_items[node.first + i];
+					if (testBox(f, m_boxes[item]) != Result::OUTSIDE) {
+						visible.push_back(item);
+					}
+				}
+			}
+			else {
+				stack[top++] = node.first;
+				stack[top++] = node.first + 1;
+			}
+		}
+
+		// front-to-back: distance from the eye to the closest point of each box
+		m_sortKeys.resize(visible.size());
+		for (size_t i = 0; i < visible.size(); i++) {
+			const BvhAabb& b = m_boxes[visible[i]];
+			const glm::vec3 closest = glm::clamp(eye, b.min, b.max);
+			const glm::vec3 diff = closest - eye;
+			m_sortKeys[i] = { glm::dot(diff, diff), visible[i] };
+		}
+		std::sort(m_sortKeys.begin(), m_sortKeys.end(),
+			[](const SortKey& a, const SortKey& b) { return a.distance2 < b.distance2; });
+		for (size_t i = 0; i < visible.size(); i++) {
+			visible[i] = m_sortKeys[i].item;
+		}
+	}
+
+	const std::vector<Node>& nodes() const { return m_nodes; }
+	const std::vector<BvhAabb>& boxes() const { return m_boxes; }
+
+private:
+	struct FrustumSoA
+	{
+		alignas(16) float nx[8];
+		alignas(16) float ny[8];
+		alignas(16) float nz[8];
+		alignas(16) float d[8];
+	};
+
+	struct SortKey
+	{
+		float distance2;
+		uint32_t item;
+	};
+
+	static BvhAabb merge(const BvhAabb& a, const BvhAabb& b)
+	{
+		return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+	}
+
+	void subdivide(const uint32_t nodeIndex, const uint32_t first, const uint32_t count)
+	{
+		BvhAabb bounds = m_boxes[m_items[first]];
+		BvhAabb centroidBounds = { (bounds.min + bounds.max) * 0.5f, (bounds.min + bounds.max) * 0.5f };
+		for (uint32_t i = first; i < first + count; i++) {
+			const BvhAabb& b = m_boxes[m_items[i]];
+			const glm::vec3 c = (b.min + b.max) * 0.5f;
+			bounds = merge(bounds, b);
+			centroidBounds = merge(centroidBounds, { c, c });
+		}
+		m_nodes[nodeIndex].box = bounds;
+
+		if (count <= (uint32_t)MAX_LEAF_SIZE) {
+			m_nodes[nodeIndex].first = first;
+			m_nodes[nodeIndex].count = count;
+			return;
+		}
+
+		// median split on the longest centroid axis
+		const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+		const int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+		const uint32_t mid = first + count / 2;
+		std::nth_element(m_items.begin() + first, m_items.begin() + mid, m_items.begin() + first + count,
+			[this, axis](const uint32_t a, const uint32_t b) {
+				return (m_boxes[a].min[axis] + m_boxes[a].max[axis]) < (m_boxes[b].min[axis] + m_boxes[b].max[axis]);
+			});
+
+		const uint32_t left = (uint32_t)m_nodes.size();
+		m_nodes.push_back(Node());
+		m_nodes.push_back(Node());
+		m_nodes[nodeIndex].first = left;
+		m_nodes[nodeIndex].count = 0;
+		subdivide(left, first, mid - first);
+		subdivide(left + 1, mid, first + count - mid);
+	}
+
+	void appendSubtree(const Node& node, std::vector<uint32_t>& visible) const
+	{
+		if (node.count > 0) {
+			visible.insert(visible.end(), m_items.begin() + node.first, m_items.begin() + node.first + node.count);
+			return;
+		}
+		appendSubtree(m_nodes[node.first], visible);
+		appendSubtree(m_nodes[node.first + 1], visible);
+	}
+
+	// farthest corner along the plane normal decides OUTSIDE, nearest corner decides INSIDE
+	static Result testBox(const FrustumSoA& f, const BvhAabb& b)
+	{
+#if SCENE_BVH_SSE
+		const __m128 minX = _mm_set1_ps(b.min.x), minY = _mm_set1_ps(b.min.y), minZ = _mm_set1_ps(b.min.z);
+		const __m128 maxX = _mm_set1_ps(b.max.x), maxY = _mm_set1_ps(b.max.y), maxZ = _mm_set1_ps(b.max.z);
+		const __m128 zero = _mm_setzero_ps();
+		int outside = 0, intersect = 0;
+		for (int g = 0; g < 8; g += 4) {
+			const __m128 nx = _mm_load_ps(f.nx + g), ny = _mm_load_ps(f.ny + g), nz = _mm_load_ps(f.nz + g), d = _mm_load_ps(f.d + g);
+			const __m128 ax = _mm_mul_ps(nx, minX), bx = _mm_mul_ps(nx, maxX);
+			const __m128 ay = _mm_mul_ps(ny, minY), by = _mm_mul_ps(ny, maxY);
+			const __m128 az = _mm_mul_ps(nz, minZ), bz = _mm_mul_ps(nz, maxZ);
+			const __m128 farDist = _mm_add_ps(_mm_add_ps(_mm_max_ps(ax, bx), _mm_max_ps(ay, by)), _mm_add_ps(_mm_max_ps(az, bz), d));
+			const __m128 nearDist = _mm_add_ps(_mm_add_ps(_mm_min_ps(ax, bx), _mm_min_ps(ay, by)), _mm_add_ps(_mm_min_ps(az, bz), d));
+			outside |= _mm_movemask_ps(_mm_cmplt_ps(farDist, zero));
+			intersect |= _mm_movemask_ps(_mm_cmplt_ps(nearDist, zero));
+		}
+		if (outside != 0) {
+			return Result::OUTSIDE;
+		}
+		return (intersect != 0) ? Result::INTERSECT : Result::INSIDE;
+#else
+		bool intersect = false;
+		for (int i = 0; i < 6; i++) {
+			const float ax = f.nx[i] * b.min.x, bx = f.nx[i] * b.max.x;
+			const float ay = f.ny[i] * b.min.y, by = f.ny[i] * b.max.y;
+			const float az = f.nz[i] * b.min.z, bz = f.nz[i] * b.max.z;
+			const float farDist = std::max(ax, bx) + std::max(ay, by) + std::max(az, bz) + f.d[i];
+			if (farDist < 0.0f) {
+				return Result::OUTSIDE;
+			}
+			const float nearDist = std::min(ax, bx) + std::min(ay, by) + std::min(az, bz) + f.d[i];
+			intersect = intersect || (nearDist < 0.0f);
+		}
+		return intersect ? Result::INTERSECT : Result::INSIDE;
+#endif
+	}
+
+private:
+	std::vector<BvhAabb> m_boxes;
+	std::vector<uint32_t> m_items;
+	std::vector<Node> m_nodes;
+	mutable std::vector<SortKey> m_sortKeys;
+};
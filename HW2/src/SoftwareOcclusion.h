@@ -0,0 +1,367 @@
+#pragma once
+
+// CPU software occlusion culling, no GL calls at all.
+//
+// A handful of large meshes are chosen as occluders at load time. Every frame their triangles are
+// rasterized into a small 1/w depth buffer (larger = closer, 0 = empty) and mesh AABBs are tested
+// against it before any draw is issued:
+//
+//   SoftwareOcclusion occlusion(256, 144);
+//   occlusion.addOccluder(worldPositions, indices);           // once, for every selected occluder
+//   occlusion.render(proj * view);                           // every frame
+//   occlusion.filterVisible(boxes, visible);                 // drops occluded entries, keeps order
+//
+// Triangles are clipped against a near plane in clip space, set up once, then rasterized in
+// horizontal bands by a small pool of worker threads (the calling thread takes a band as well).
+// Rows are processed 4 pixels at a time with SSE when available (SOFTWARE_OCCLUSION_NO_SIMD forces
+// the scalar path).
+
+#include "SceneBVH.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(SOFTWARE_OCCLUSION_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SOFTWARE_OCCLUSION_SSE 1
+#include <xmmintrin.h>
+#else
+#define SOFTWARE_OCCLUSION_SSE 0
+#endif
+
+class SoftwareOcclusion
+{
+public:
+	// width is rounded up to a multiple of 4; threads = 0 picks hardware_concurrency - 1 (at most 3)
+	SoftwareOcclusion(const int width = 256, const int height = 144, unsigned int threads = 0) :
+		m_width((width + 3) & ~3), m_height(height)
+	{
+		m_depth.assign((size_t)m_width * m_height, 0.0f);
+		if (threads == 0) {
+			const unsigned int hw = std::thread::hardware_concurrency();
+			threads = (hw > 1) ? std::min(hw - 1, 3u) : 0u;
+		}
+		for (unsigned int i = 0; i < threads; i++) {
+			m_workers.emplace_back(&SoftwareOcclusion::workerLoop, this, i + 1);
+		}
+	}
+
+	~SoftwareOcclusion()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& t : m_workers) {
+			t.join();
+		}
+	}
+
+	SoftwareOcclusion(const SoftwareOcclusion&) = delete;
+	SoftwareOcclusion& operator=(const SoftwareOcclusion&) = delete;
+
+	// Picks meshes whose largest AABB face is big, skipping the ones that are too dense to rasterize
+	// cheaply. Returns mesh indices, biggest first.
+	static std::vector<uint32_t> selectOccluders(const std::vector<BvhAabb>& boxes, const std::vector<uint32_t>& triangleCounts,
+		const size_t maxOccluders, const uint32_t maxTrianglesPerOccluder)
+	{
+		std::vector<std::pair<float, uint32_t>> scored;
+		for (size_t i = 0; i < boxes.size(); i++) {
+			if (triangleCounts[i] == 0 || triangleCounts[i] > maxTrianglesPerOccluder) {
+				continue;
+			}
+			const glm::vec3 e = boxes[i].max - boxes[i].min;
+			const float largestFace = std::max(e.x * e.y, std::max(e.y * e.z, e.x * e.z));
+			scored.push_back({ largestFace, (uint32_t)i });
+		}
+		std::sort(scored.begin(), scored.end(), [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) { return a.first > b.first; });
+		std::vector<uint32_t> result;
+		for (size_t i = 0; i < scored.size() && i < maxOccluders; i++) {
+			result.push_back(scored[i].second);
+		}
+		return result;
+	}
+
+	void addOccluder(const std::vector<glm::vec3>& worldPositions, const std::vector<uint32_t>& indices)
+	{
+		const uint32_t base = (uint32_t)m_positions.size();
+		m_positions.insert(m_positions.end(), worldPositions.begin(), worldPositions.end());
+		for (uint32_t idx : indices) {
+			m_indices.push_back(base + idx);
+		}
+	}
+
+	void clearOccluders()
+	{
+		m_positions.clear();
+		m_indices.clear();
+	}
+
+	void render(const glm::mat4& viewProj)
+	{
+		m_viewProj = viewProj;
+		setupTriangles();
+
+		// band 0 on this thread, the rest on the workers
+		const int bands = (int)m_workers.size() + 1;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending = (int)m_workers.size();
+			m_generation++;
+		}
+		m_wake.notify_all();
+		rasterizeBand(0, bands);
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_pending == 0; });
+	}
+
+	// conservative: anything touching the near plane or leaving the screen rect partially is visible
+	bool isVisible(const BvhAabb& box) const
+	{
+		float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearestInvW = 0.0f;
+		for (int c = 0; c < 8; c++) {
+			const glm::vec4 p = m_viewProj * glm::vec4((c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z, 1.0f);
+			if (p.w <= NEAR_W) {
+				return true;
+			}
+			const float invW = 1.0f / p.w;
+			const float sx = (p.x * invW * 0.5f + 0.5f) * m_width;
+			const float sy = (p.y * invW * 0.5f + 0.5f) * m_height;
+			minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+			minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+			nearestInvW = std::max(nearestInvW, invW);
+		}
+		const int x0 = std::max(0, (int)std::floor(minX) - 1), x1 = std::min(m_width - 1, (int)std::ceil(maxX) + 1);
+		const int y0 = std::max(0, (int)std::floor(minY) - 1), y1 = std::min(m_height - 1, (int)std::ceil(maxY) + 1);
+		if (x0 > x1 || y0 > y1) {
+			return false; // entirely off screen, the frustum test normally catches this first
+		}
+
+		// visible as soon as one pixel of the rect has nothing closer than the box's nearest point
+		const float threshold = nearestInvW * (1.0f + DEPTH_BIAS);
+		for (int y = y0; y <= y1; y++) {
+			const float* row = &m_depth[(size_t)y * m_width];
+			int x = x0;
+#if SOFTWARE_OCCLUSION_SSE
+			const __m128 t = _mm_set1_ps(threshold);
+			for (; x + 3 <= x1; x += 4) {
+				if (_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(row + x), t)) != 0) {
+					return true;
+				}
+			}
+#endif
+			for (; x <= x1; x++) {
+				if (row[x] < threshold) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// removes occluded entries of visible (indices into boxes), the order of the rest is kept
+	void filterVisible(const std::vector<BvhAabb>& boxes, std::vector<uint32_t>& visible) const
+	{
+		visible.erase(std::remove_if(visible.begin(), visible.end(), [&](const uint32_t i) { return !isVisible(boxes[i]); }), visible.end());
+	}
+
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+	const std::vector<float>& depthBuffer() const { return m_depth; }
+	size_t numOccluderTriangles() const { return m_indices.size() / 3; }
+	size_t numRasterizedTriangles() const { return m_triangles.size(); }
+
+private:
+	static constexpr float NEAR_W = 0.05f;       // clip-space w of the near clipping plane
+	static constexpr float DEPTH_BIAS = 1e-3f;   // relative, keeps occluders from hiding themselves
+
+	// screen-space triangle with edge functions (inside = all >= 0, shared edges must not leave
+	// cracks) and a 1/w plane
+	struct Triangle
+	{
+		float a[3], b[3], c[3];
+		float zdx, zdy, z0;
+		int minX, maxX, minY, maxY;
+	};
+
+	void setupTriangles()
+	{
+		m_triangles.clear();
+		m_clip.resize(m_positions.size());
+		for (size_t i = 0; i < m_positions.size(); i++) {
+			m_clip[i] = m_viewProj * glm::vec4(m_positions[i], 1.0f);
+		}
+
+		for (size_t t = 0; t + 2 < m_indices.size(); t += 3) {
+			glm::vec4 in[3] = { m_clip[m_indices[t]], m_clip[m_indices[t + 1]], m_clip[m_indices[t + 2]] };
+
+			// trivial reject against one side of the frustum
+			bool rejected = false;
+			for (int axis = 0; axis < 3 && !rejected; axis++) {
+				if (in[0][axis] > in[0].w && in[1][axis] > in[1].w && in[2][axis] > in[2].w) rejected = true;
+				if (in[0][axis] < -in[0].w && in[1][axis] < -in[1].w && in[2][axis] < -in[2].w) rejected = true;
+			}
+			if (rejected) {
+				continue;
+			}
+
+			// clip against w = NEAR_W (Sutherland-Hodgman, one plane -> at most 4 vertices)
+			glm::vec4 poly[4];
+			int n = 0;
+			for (int i = 0; i < 3; i++) {
+				const glm::vec4& p = in[i];
+				const glm::vec4& q = in[(i + 1) % 3];
+				const bool pIn = p.w >= NEAR_W, qIn = q.w >= NEAR_W;
+				if (pIn) {
+					poly[n++] = p;
+				}
+				if (pIn != qIn) {
+					const float s = (NEAR_W - p.w) / (q.w - p.w);
+					poly[n++] = p + (q - p) * s;
+				}
+			}
+			for (int i = 1; i + 1 < n; i++) {
+				addTriangle(poly[0], poly[i], poly[i + 1]);
+			}
+		}
+	}
+
+	void addTriangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2)
+	{
+		const glm::vec4* clip[3] = { &c0, &c1, &c2 };
+		float x[3], y[3], z[3];
+		for (int i = 0; i < 3; i++) {
+			const float invW = 1.0f / clip[i]->w;
+			x[i] = (clip[i]->x * invW * 0.5f + 0.5f) * m_width;
+			y[i] = (clip[i]->y * invW * 0.5f + 0.5f) * m_height;
+			z[i] = invW;
+		}
+
+		Triangle tri;
+		// edge i is opposite vertex i: e(p) = a*px + b*py + c
+		for (int i = 0; i < 3; i++) {
+			const int j = (i + 1) % 3, k = (i + 2) % 3;
+			tri.a[i] = y[j] - y[k];
+			tri.b[i] = x[k] - x[j];
+			tri.c[i] = x[j] * y[k] - y[j] * x[k];
+		}
+		const float area = tri.a[0] * x[0] + tri.b[0] * y[0] + tri.c[0];
+		if (std::fabs(area) < 1e-6f) {
+			return;
+		}
+		// occluders are two-sided: flip the edges of clockwise triangles so inside is always >= 0
+		const float s = (area > 0.0f) ? 1.0f : -1.0f;
+		const float invArea = 1.0f / std::fabs(area);
+		tri.zdx = tri.zdy = tri.z0 = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			tri.a[i] *= s; tri.b[i] *= s; tri.c[i] *= s;
+			tri.zdx += z[i] * tri.a[i] * invArea;
+			tri.zdy += z[i] * tri.b[i] * invArea;
+			tri.z0 += z[i] * tri.c[i] * invArea;
+		}
+
+		tri.minX = std::max(0, (int)std::floor(std::min(x[0], std::min(x[1], x[2]))));
+		tri.maxX = std::min(m_width - 1, (int)std::ceil(std::max(x[0], std::max(x[1], x[2]))));
+		tri.minY = std::max(0, (int)std::floor(std::min(y[0], std::min(y[1], y[2]))));
+		tri.maxY = std::min(m_height - 1, (int)std::ceil(std::max(y[0], std::max(y[1], y[2]))));
+		if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+			return;
+		}
+		m_triangles.push_back(tri);
+	}
+
+	void rasterizeBand(const int band, const int bands)
+	{
+		const int rowBegin = m_height * band / bands;
+		const int rowEnd = m_height * (band + 1) / bands;
+		std::fill(m_depth.begin() + (size_t)rowBegin * m_width, m_depth.begin() + (size_t)rowEnd * m_width, 0.0f);
+
+		for (const Triangle& t : m_triangles) {
+			const int y0 = std::max(t.minY, rowBegin), y1 = std::min(t.maxY, rowEnd - 1);
+			for (int y = y0; y <= y1; y++) {
+				const float py = (float)y + 0.5f;
+				float* row = &m_depth[(size_t)y * m_width];
+				int x = t.minX & ~3;
+#if SOFTWARE_OCCLUSION_SSE
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 step = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+				const __m128 row0 = _mm_set1_ps(t.b[0] * py + t.c[0]), a0 = _mm_set1_ps(t.a[0]);
+				const __m128 row1 = _mm_set1_ps(t.b[1] * py + t.c[1]), a1 = _mm_set1_ps(t.a[1]);
+				const __m128 row2 = _mm_set1_ps(t.b[2] * py + t.c[2]), a2 = _mm_set1_ps(t.a[2]);
+				const __m128 rowZ = _mm_set1_ps(t.zdy * py + t.z0), zdx = _mm_set1_ps(t.zdx);
+				for (; x <= t.maxX; x += 4) {
+					const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), step);
+					const __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+					const __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+					const __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+					const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+					if (_mm_movemask_ps(inside) == 0) {
+						continue;
+					}
+					const __m128 z = _mm_add_ps(_mm_mul_ps(zdx, px), rowZ);
+					const __m128 old = _mm_loadu_ps(row + x);
+					const __m128 closer = _mm_max_ps(old, z);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, old)));
+				}
+#else
+				for (; x <= t.maxX; x++) {
+					const float px = (float)x + 0.5f;
+					const float e0 = t.a[0] * px + t.b[0] * py + t.c[0];
+					const float e1 = t.a[1] * px + t.b[1] * py + t.c[1];
+					const float e2 = t.a[2] * px + t.b[2] * py + t.c[2];
+					if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) {
+						row[x] = std::max(row[x], t.zdx * px + t.zdy * py + t.z0);
+					}
+				}
+#endif
+			}
+		}
+	}
+
+	void workerLoop(const int band)
+	{
+		unsigned long long seen = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_quit || m_generation != seen; });
+				if (m_quit) {
+					return;
+				}
+				seen = m_generation;
+			}
+			rasterizeBand(band, (int)m_workers.size() + 1);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pending--;
+			}
+			m_done.notify_one();
+		}
+	}
+
+private:
+	const int m_width;
+	const int m_height;
+	std::vector<float> m_depth;        // m_width x m_height, rows start on multiples of 4
+	glm::mat4 m_viewProj = glm::mat4(1.0f);
+
+	std::vector<glm::vec3> m_positions; // all occluders, world space
+	std::vector<uint32_t> m_indices;
+	std::vector<glm::vec4> m_clip;
+	std::vector<Triangle> m_triangles;
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	unsigned long long m_generation = 0;
+	int m_pending = 0;
+	bool m_quit = false;
+};
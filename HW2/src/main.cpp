@@ -3,8 +3,19 @@
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include "GpuProfiler.h"
+#include "CpuTrace.h"
+#include "SceneBVH.h"
+#include "SoftwareOcclusion.h"
+#include "RenderQueue.h"
+#include "RenderTargetPool.h"
+#include "FrameCapture.h"
+#include "CpuPostEffects.h"
 #include <stdio.h>
 #include <iostream>
+#include <map>
+#include <set>
+#include <random>
 #define GL_SILENCE_DEPRECATION
 #include <GLFW/glfw3.h>
 
@@ -18,7 +29,6 @@ using namespace std;
 ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
 int g_sceneRenderMode = 0; // 0: Textured, 1: Normal Color
-int g_postEffectMode = 0;  // 0: None, 1: Pixelization, etc.
 static float g_BarPosition = 0.5f;
 bool g_EnableComparisonBar = false;
 bool g_DraggingBar = false;
@@ -27,22 +37,36 @@ static float g_SinePower1 = 0.02f;
 static float g_SinePower2 = 20.0f;
 float g_PixelSize = 16.0f;
 
+// isWj簣G0 = e, 1 = BVH @簣 (Ѫ컷Ƨ), 2 = @ + occlusion query,
+// 3 = @ + CPU nB׭簣 ( GPU queryA]Ū^)
+static int g_cullMode = 1;
+static std::vector<uint32_t> g_visibleMeshes;
+static size_t g_inFrustumCount = 0;
+static SoftwareOcclusion g_softwareOcclusion(256, 144);
+
+// isWj簣᪺ draw  (program, material, VAO, `) ƧǡAƪ bind  state cache ٱ
+static RenderQueue g_renderQueue;
+static GlStateCache g_glState;
+static bool g_sortDrawsByState = true;
+
+static GpuProfiler g_gpuProfiler; // isWjscene / post U۪ GPU ɶ
+static FrameCapture g_frameCapture; // isWjv (PBO DPBŪ^A|d GPU)
+
 struct Vertex {
 	glm::vec3 pos;
 	glm::vec3 normal;
 	glm::vec2 uv;
 };
 
-struct TextureGL {
-	unsigned int id = 0;
-	std::string path;
-};
-
 static void expandAABB(glm::vec3& bmin, glm::vec3& bmax, const glm::vec3& p) {
     bmin = glm::min(bmin, p);
     bmax = glm::max(bmax, p);
 }
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1 // KHR/ARB_parallel_shader_compile
+#endif
+
 static unsigned int compileShader(GLenum type, const char* src) {
     GLuint s = glCreateShader(type);
     glShaderSource(s, 1, &src, nullptr);
@@ -57,9 +81,29 @@ static std::string loadFileStr(const std::string& p) {
     std::stringstream ss; ss << ifs.rdbuf(); return ss.str();
 }
 
-static unsigned int buildProgramFromFiles(const std::string& vsPath, const std::string& fsPath) {
-    std::string v = loadFileStr(vsPath);
-    std::string f = loadFileStr(fsPath);
+// isWjŪ shader îi} #include "xxx.glsl" (|۹ثeɮסAui}@hN)
+static std::string expandShaderIncludes(const std::string& src, const std::string& dir) {
+    std::stringstream in(src), out;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t q0 = line.find('"');
+        const size_t q1 = (q0 == std::string::npos) ? q0 : line.find('"', q0 + 1);
+        if (line.compare(0, 8, "#include") == 0 && q1 != std::string::npos)
+            out << loadFileStr(dir + line.substr(q0 + 1, q1 - q0 - 1)) << "\n";
+        else
+            out << line << "\n";
+    }
+    return out.str();
+}
+
+static std::string loadShaderSource(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    const std::string dir = (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
+    return expandShaderIncludes(loadFileStr(path), dir);
+}
+
+// iקjXӵɲͪ shader (fused s) 
+static unsigned int buildProgramFromSources(const std::string& v, const std::string& f) {
     GLuint vs = compileShader(GL_VERTEX_SHADER, v.c_str());
     GLuint fs = compileShader(GL_FRAGMENT_SHADER, f.c_str());
     GLuint prog = glCreateProgram();
@@ -71,7 +115,148 @@ static unsigned int buildProgramFromFiles(const std::string& vsPath, const std::
     return prog;
 }
 
+static unsigned int buildProgramFromFiles(const std::string& vsPath, const std::string& fsPath) {
+    TRACE_SCOPE("buildProgramFromFiles");
+    return buildProgramFromSources(loadShaderSource(vsPath), loadShaderSource(fsPath));
+}
+
+// isWj #define b #version ᭱ (P@ shader sP)
+static std::string withDefines(std::string src, const std::string& defines) {
+    if (!defines.empty()) src.insert(src.find('\n') + 1, defines);
+    return src;
+}
+
+// isWjcompute shader u@ stage
+static unsigned int buildComputeProgramFromFile(const std::string& csPath, const std::string& defines = "") {
+    TRACE_SCOPE("buildComputeProgramFromFile");
+    std::string c = withDefines(loadShaderSource(csPath), defines);
+    GLuint cs = compileShader(GL_COMPUTE_SHADER, c.c_str());
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, cs);
+    glLinkProgram(prog);
+    GLint ok; glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) { char log[2048]; glGetProgramInfoLog(prog, 2048, nullptr, log); fprintf(stderr, "Program link error (%s):\n%s\n", csPath.c_str(), log); }
+    glDeleteShader(cs);
+    return prog;
+}
+
+// isWjueX compile / linkBdG (vs OŦrN compute shader)C
+//  parallel shader compile  driver |bIsAG浹 ShaderPermutations Ad
+static GLuint startProgramBuild(const std::string& vs, const std::string& fsOrCs) {
+    GLuint prog = glCreateProgram();
+    const auto attach = [prog](GLenum type, const std::string& src) {
+        GLuint s = glCreateShader(type);
+        const char* p = src.c_str();
+        glShaderSource(s, 1, &p, nullptr);
+        glCompileShader(s);
+        glAttachShader(prog, s);
+        glDeleteShader(s); // program ٱۡAlink ~uR
+    };
+    if (vs.empty()) {
+        attach(GL_COMPUTE_SHADER, fsOrCs);
+    }
+    else {
+        attach(GL_VERTEX_SHADER, vs);
+        attach(GL_FRAGMENT_SHADER, fsOrCs);
+    }
+    glLinkProgram(prog);
+    return prog;
+}
+
+// isWjshader permutation ֨GP@ shader (base) tWP #define զXUs@A base + defines  keyC
+//  KHR/ARB_parallel_shader_compile ɦbIsAsneΦP@ base Wsn ( fallback)A
+// ҥH GUI  slider `Ƥ|deC
+// iקjbase OiHۥNGP@ base Uutbiժ`ơA OUTPUT_FORMAT oط|ܤ
+// ngi baseCP@ base udeWbΪMbnAª (]A٨SsNQ) R
+struct ShaderPermutations {
+    struct Entry {
+        GLuint program = 0;
+        bool ready = false;
+    };
+    std::map<std::string, Entry> entries;
+    std::map<std::string, GLuint> lastReady; // base  ̪@sn program
+    std::vector<std::string> errors;         // isWjlink Ѫ "base: Ĥ@ log"AGUI 
+    bool parallel = false;
+
+    void init() {
+        parallel = glfwExtensionSupported("GL_KHR_parallel_shader_compile") || glfwExtensionSupported("GL_ARB_parallel_shader_compile");
+        typedef void (APIENTRYP MaxShaderCompilerThreadsFn)(GLuint count);
+        MaxShaderCompilerThreadsFn maxThreads = (MaxShaderCompilerThreadsFn)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        if (!maxThreads) maxThreads = (MaxShaderCompilerThreadsFn)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        if (parallel && maxThreads) maxThreads(0xFFFFFFFFu); // ƥ浹 driver Mw
+    }
+
+    // build() ubo key Ĥ@X{ɩIsAn^ startProgramBuild G
+    template <class Build>
+    GLuint get(const std::string& base, const std::string& defines, GLuint fallback, Build build) {
+        const std::string key = base + "\n" + defines;
+        auto found = entries.find(key);
+        if (found == entries.end()) {
+            evict(base, key); // F`ơAen (i٦bs) ΤF
+            found = entries.emplace(key, Entry()).first;
+        }
+        Entry& e = found->second;
+        if (!e.ready) {
+            if (!e.program) e.program = build();
+            GLint done = GL_TRUE;
+            if (parallel) glGetProgramiv(e.program, GL_COMPLETION_STATUS_KHR, &done);
+            if (done) {
+                e.ready = true;
+                GLint ok; glGetProgramiv(e.program, GL_LINK_STATUS, &ok);
+                if (!ok) {
+                    char log[2048]; glGetProgramInfoLog(e.program, 2048, nullptr, log);
+                    fprintf(stderr, "Program link error (%s):\n%s\n", base.c_str(), log);
+                    const std::string message(log);
+                    errors.push_back(base + ": " + message.substr(0, message.find('\n')));
+                    glDeleteProgram(e.program);
+                    e.program = 0; // Ѥ]OAnCVs
+                }
+            }
+        }
+        if (e.ready && e.program) {
+            if (lastReady[base] != e.program) {
+                lastReady[base] = e.program;
+                evict(base, key); // ssnFA쥻Ϊ]iHF
+            }
+            return e.program;
+        }
+        auto it = lastReady.find(base);
+        return it != lastReady.end() ? it->second : fallback;
+    }
+
+    // RP@ base UF keep Mثe (lastReady) H~ permutation
+    void evict(const std::string& base, const std::string& keep) {
+        auto ready = lastReady.find(base);
+        const GLuint current = ready != lastReady.end() ? ready->second : 0;
+        const std::string prefix = base + "\n";
+        for (auto it = entries.lower_bound(prefix); it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+            if (it->first == keep || (current && it->second.program == current)) {
+                ++it;
+                continue;
+            }
+            if (it->second.program) glDeleteProgram(it->second.program);
+            it = entries.erase(it);
+        }
+    }
+
+    int pending() const {
+        int n = 0;
+        for (const auto& e : entries) n += e.second.ready ? 0 : 1;
+        return n;
+    }
+
+    void release() {
+        for (auto& e : entries)
+            if (e.second.program) glDeleteProgram(e.second.program);
+        entries.clear();
+        lastReady.clear();
+        errors.clear();
+    }
+};
+static ShaderPermutations g_shaderPermutations;
+
 static unsigned int loadTexture2D(const std::string& file, bool flipY = true) {
+    TRACE_SCOPE("loadTexture2D");
     stbi_set_flip_vertically_on_load(flipY);
     int w, h, n; unsigned char* data = stbi_load(file.c_str(), &w, &h, &n, 0);
     if (!data) {
@@ -98,101 +283,148 @@ static unsigned int loadTexture2D(const std::string& file, bool flipY = true) {
     return tex;
 }
 
+// iקjGLMesh A֦ۤv VAO/VBO/EBOAuOb Model @Τj buffer ̪d
 struct GLMesh {
-    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLuint firstIndex = 0;   // @ EBO ̪ index _I
+    GLuint baseVertex = 0;   // @ VBO ̪I_I (index O mesh ۹)
     GLsizei indexCount = 0;
-    TextureGL diffuse;
-    void draw() const {
-        glBindVertexArray(vao);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, diffuse.id);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    }
+    GLuint material = 0;     // Model::materials  index
+    glm::vec3 bmin = glm::vec3(0.0f), bmax = glm::vec3(0.0f); // mesh ۤv AABB (model space)
+};
+
+// isWjglMultiDrawElementsIndirect O榡 (DrawElementsIndirectCommand)
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;  // s draw indexAshader i gl_BaseInstance dC draw 
 };
 
 static std::string g_dir; // Ƨ|e
-static std::unordered_map<std::string, TextureGL> g_texCache;
-
-static TextureGL loadMaterialTexture(aiMaterial* mat, aiTextureType type) {
-    if (mat->GetTextureCount(type) == 0) return {};
-    aiString str; mat->GetTexture(type, 0, &str);
-    std::string rel = str.C_Str();
-    std::string full = g_dir + rel;
-    if (g_texCache.count(full)) return g_texCache[full];
-    TextureGL t; t.id = loadTexture2D(full); t.path = full;
-    g_texCache[full] = t; return t;
-}
-
-glm::vec3 lmin(std::numeric_limits<float>::infinity());
-glm::vec3 lmax(-std::numeric_limits<float>::infinity());
-
-static GLMesh processMesh(const aiMesh* m, const aiScene* scene, aiMaterial* mat) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    vertices.reserve(m->mNumVertices);
-    for (unsigned i = 0; i < m->mNumVertices; ++i) {
-        Vertex v{};
-        v.pos = glm::vec3(m->mVertices[i].x, m->mVertices[i].y, m->mVertices[i].z);
-        v.normal = m->HasNormals() ? glm::vec3(m->mNormals[i].x, m->mNormals[i].y, m->mNormals[i].z) : glm::vec3(0, 1, 0);
-        if (m->mTextureCoords[0]) {
-            v.uv = glm::vec2(m->mTextureCoords[0][i].x, m->mTextureCoords[0][i].y);
-        }
-        else v.uv = glm::vec2(0);
-        lmin = glm::min(lmin, v.pos);
-        lmax = glm::max(lmax, v.pos);
-        vertices.push_back(v);
-    }
-    for (unsigned f = 0; f < m->mNumFaces; ++f) {
-        const aiFace& face = m->mFaces[f];
-        for (unsigned j = 0; j < face.mNumIndices; ++j) indices.push_back(face.mIndices[j]);
-    }
-    GLMesh out{};
-    glGenVertexArrays(1, &out.vao);
-    glGenBuffers(1, &out.vbo);
-    glGenBuffers(1, &out.ebo);
-    glBindVertexArray(out.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, out.vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, out.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned), indices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0); // pos
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(1); // normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(2); // uv
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-    out.indexCount = (GLsizei)indices.size();
-    // uĤ@i diffuse]Sponza hAܽd²ơ^
-    out.diffuse = loadMaterialTexture(mat, aiTextureType_DIFFUSE);
-    if (out.diffuse.id == 0) { // S diffuse NΥնK
-        out.diffuse.id = loadTexture2D(g_dir + "KAMEN.JPG"); // Υ@sbϡFsb]| fallback
-    }
-    return out;
-}
-
-static void processNode(const aiNode* node, const aiScene* scene, std::vector<GLMesh>& meshes) {
-    for (unsigned i = 0; i < node->mNumMeshes; ++i) {
-        aiMesh* m = scene->mMeshes[node->mMeshes[i]];
-        aiMaterial* mat = scene->mMaterials[m->mMaterialIndex];
-        meshes.emplace_back(processMesh(m, scene, mat));
-    }
-    for (unsigned i = 0; i < node->mNumChildren; ++i)
-        processNode(node->mChildren[i], scene, meshes);
+
+// isWjGdiffuse KϩbuPؤo@աv texture array ̡Ashader  (bucket, layer) 
+// o˴褣 glBindTextureAӳiH@ MultiDraw
+struct Material {
+    std::string diffusePath;
+    GLuint bucket = 0;  // ĴX texture array (uBucket[bucket])
+    GLuint layer = 0;   // array ̪ĴXh
+};
+
+static const int MAX_TEXTURE_BUCKETS = 8; // n scene_fs.glsl  uBucket[] jp@
+
+static std::string diffusePathOf(aiMaterial* mat) {
+    if (mat->GetTextureCount(aiTextureType_DIFFUSE) == 0) return g_dir + "KAMEN.JPG"; // S diffuse NγoiFsb]| fallback
+    aiString str; mat->GetTexture(aiTextureType_DIFFUSE, 0, &str);
+    return g_dir + str.C_Str();
+}
+
+// ̶KϤؤoաACիؤ@ GL_TEXTURE_2D_ARRAYA^Cӧ誺 (bucket, layer)
+// ؤoWL MAX_TEXTURE_BUCKETS ɡAѤUγ̪IYiĤ@ (̱`ؤo)
+static std::vector<GLuint> buildMaterialTextureArrays(std::vector<Material>& materials) {
+    TRACE_SCOPE("buildMaterialTextureArrays");
+    struct Image { int w, h; std::vector<unsigned char> rgba; };
+    std::vector<Image> images(materials.size());
+
+    stbi_set_flip_vertically_on_load(true);
+    for (size_t i = 0; i < materials.size(); ++i) {
+        int w, h, n;
+        unsigned char* data = stbi_load(materials[i].diffusePath.c_str(), &w, &h, &n, 4);
+        if (!data) {
+            fprintf(stderr, "Texture load failed: %s\n", materials[i].diffusePath.c_str());
+            images[i] = { 1, 1, { 255, 255, 255, 255 } }; // fallback: 1x1 զ
+            continue;
+        }
+        images[i] = { w, h, std::vector<unsigned char>(data, data + (size_t)w * h * 4) };
+        stbi_image_free(data);
+    }
+
+    // ؤo -> ϥΦơAƦh bucket
+    std::map<std::pair<int, int>, int> sizeCount;
+    for (const Image& img : images) sizeCount[{ img.w, img.h }]++;
+    std::vector<std::pair<std::pair<int, int>, int>> sizes(sizeCount.begin(), sizeCount.end());
+    std::stable_sort(sizes.begin(), sizes.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (sizes.size() > (size_t)MAX_TEXTURE_BUCKETS) sizes.resize(MAX_TEXTURE_BUCKETS);
+
+    std::vector<std::vector<size_t>> bucketMembers(sizes.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        size_t b = 0;
+        for (size_t k = 0; k < sizes.size(); ++k) {
+            if (sizes[k].first == std::make_pair(images[i].w, images[i].h)) { b = k; break; }
+        }
+        const int bw = sizes[b].first.first, bh = sizes[b].first.second;
+        if (images[i].w != bw || images[i].h != bh) { // ̪IY
+            std::vector<unsigned char> resized((size_t)bw * bh * 4);
+            for (int y = 0; y < bh; ++y)
+                for (int x = 0; x < bw; ++x) {
+                    const int sx = x * images[i].w / bw, sy = y * images[i].h / bh;
+                    memcpy(&resized[((size_t)y * bw + x) * 4], &images[i].rgba[((size_t)sy * images[i].w + sx) * 4], 4);
+                }
+            images[i] = { bw, bh, std::move(resized) };
+        }
+        materials[i].bucket = (GLuint)b;
+        materials[i].layer = (GLuint)bucketMembers[b].size();
+        bucketMembers[b].push_back(i);
+    }
+
+    std::vector<GLuint> arrays(sizes.size(), 0);
+    for (size_t b = 0; b < sizes.size(); ++b) {
+        const int w = sizes[b].first.first, h = sizes[b].first.second;
+        const GLsizei layers = (GLsizei)bucketMembers[b].size();
+        GLsizei levels = 1;
+        while ((std::max(w, h) >> levels) > 0) levels++;
+
+        glGenTextures(1, &arrays[b]);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[b]);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, w, h, layers);
+        for (GLsizei l = 0; l < layers; ++l) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, l, w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, images[bucketMembers[b][l]].rgba.data());
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        fprintf(stderr, "[Material] bucket %zu: %dx%d, %d layers\n", b, w, h, (int)layers);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return arrays;
 }
 
 struct Model {
-    std::vector<GLMesh> meshes;
+    // iקjҦ mesh iP@ VBO/EBOAC mesh @ indirect command
+    std::vector<GLMesh> meshes;             //  material ƧǡAP誺 command s
+    std::vector<Material> materials;
+    std::vector<GLuint> textureBuckets;     // CضKϤؤo@ GL_TEXTURE_2D_ARRAY
+    GLuint vao = 0, vbo = 0, ebo = 0, indirectBuffer = 0;
+    GLuint drawMaterialBuffer = 0;          // SSBO binding 0: draw index -> material index
+    GLuint materialBuffer = 0;              // SSBO binding 1: material index -> (bucket, layer)
     glm::vec3 bmin, bmax;  // ` AABB
     bool hasBounds = false;
 
+    // isWj簣ΡGC mesh  world AABB ئ BVHAi command CVgi culledIndirectBuffer
+    std::vector<DrawElementsIndirectCommand> cmds;
+    SceneBVH bvh;
+    GLuint culledIndirectBuffer = 0;
+    std::vector<DrawElementsIndirectCommand> culledCmds;
+
+    // isWjnB׭簣nb CPU WeBתAOd@ local space mP index
+    std::vector<glm::vec3> cpuPositions;
+    std::vector<unsigned int> cpuIndices;
+
     void load(const std::string& path) {
+        TRACE_SCOPE("Model::load");
         Assimp::Importer importer;
         unsigned flags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
             aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices |
             aiProcess_ImproveCacheLocality | aiProcess_SortByPType |
             aiProcess_GenUVCoords | aiProcess_OptimizeMeshes |
             aiProcess_ValidateDataStructure | aiProcess_FlipUVs;
-        const aiScene* scene = importer.ReadFile(path, flags);
+        const aiScene* scene = nullptr;
+        {
+            TRACE_SCOPE("Assimp::ReadFile");
+            scene = importer.ReadFile(path, flags);
+        }
         if (!scene || !scene->mRootNode) {
             fprintf(stderr, "Assimp load failed: %s\n", importer.GetErrorString());
             return;
@@ -201,20 +433,27 @@ struct Model {
         g_dir = (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
 
         meshes.clear();
+        materials.clear();
         // l AABB
         bmin = glm::vec3(std::numeric_limits<float>::infinity());
         bmax = glm::vec3(-std::numeric_limits<float>::infinity());
         hasBounds = false;
 
+        // b CPU Ҧ mesh @Ӥj}CA̫@W
+        std::vector<Vertex> allVertices;
+        std::vector<unsigned int> allIndices;
+        std::unordered_map<std::string, GLuint> materialOfPath; // diffuse | -> material index
+
         // X node
         std::function<void(const aiNode*)> walk = [&](const aiNode* node) {
             for (unsigned i = 0; i < node->mNumMeshes; ++i) {
                 aiMesh* m = scene->mMeshes[node->mMeshes[i]];
                 aiMaterial* mat = scene->mMaterials[m->mMaterialIndex];
-                //  processMesh e lmin/lmax p]Χ lmin/lmax zL^ǱaXӡ^
-                std::vector<Vertex> vertices;
-                std::vector<unsigned int> indices;
-                vertices.reserve(m->mNumVertices);
+
+                GLMesh out{};
+                out.baseVertex = (GLuint)allVertices.size();
+                out.firstIndex = (GLuint)allIndices.size();
+
                 glm::vec3 lmin(std::numeric_limits<float>::infinity());
                 glm::vec3 lmax(-std::numeric_limits<float>::infinity());
                 for (unsigned vi = 0; vi < m->mNumVertices; ++vi) {
@@ -224,33 +463,28 @@ struct Model {
                     if (m->mTextureCoords[0])
                         v.uv = glm::vec2(m->mTextureCoords[0][vi].x, m->mTextureCoords[0][vi].y);
                     else v.uv = glm::vec2(0);
-                    vertices.push_back(v);
+                    allVertices.push_back(v);
                     lmin = glm::min(lmin, v.pos);
                     lmax = glm::max(lmax, v.pos);
                 }
                 for (unsigned f = 0; f < m->mNumFaces; ++f) {
                     const aiFace& face = m->mFaces[f];
-                    for (unsigned j = 0; j < face.mNumIndices; ++j) indices.push_back(face.mIndices[j]);
+                    for (unsigned j = 0; j < face.mNumIndices; ++j) allIndices.push_back(face.mIndices[j]);
                 }
-                //  GLMesh ]A쥻ۦP^
-                GLMesh out{};
-                glGenVertexArrays(1, &out.vao);
-                glGenBuffers(1, &out.vbo);
-                glGenBuffers(1, &out.ebo);
-                glBindVertexArray(out.vao);
-                glBindBuffer(GL_ARRAY_BUFFER, out.vbo);
-                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, out.ebo);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned), indices.data(), GL_STATIC_DRAW);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-                glEnableVertexAttribArray(2);
-                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-                out.indexCount = (GLsizei)indices.size();
-                out.diffuse = loadMaterialTexture(mat, aiTextureType_DIFFUSE);
-                if (out.diffuse.id == 0) out.diffuse.id = loadTexture2D(g_dir + "KAMEN.JPG");
+                out.indexCount = (GLsizei)(allIndices.size() - out.firstIndex);
+                out.bmin = lmin;
+                out.bmax = lmax;
+
+                // P@iKϵP@ӧ (Kϵ mesh A@_ texture array)
+                const std::string diffusePath = diffusePathOf(mat);
+                auto it = materialOfPath.find(diffusePath);
+                if (it == materialOfPath.end()) {
+                    it = materialOfPath.emplace(diffusePath, (GLuint)materials.size()).first;
+                    Material material;
+                    material.diffusePath = diffusePath;
+                    materials.push_back(material);
+                }
+                out.material = it->second;
 
                 meshes.emplace_back(out);
 
@@ -262,11 +496,164 @@ struct Model {
             };
         walk(scene->mRootNode);
 
-        fprintf(stderr, "[Model] meshes=%zu  AABB min(%.2f,%.2f,%.2f) max(%.2f,%.2f,%.2f)\n",
-            meshes.size(), bmin.x, bmin.y, bmin.z, bmax.x, bmax.y, bmax.z);
+        // P誺 mesh Ʀb@_ (۾F draw ˦P@hKϡAcache ͵)
+        std::stable_sort(meshes.begin(), meshes.end(),
+            [](const GLMesh& a, const GLMesh& b) { return a.material < b.material; });
+
+        cmds.assign(meshes.size(), DrawElementsIndirectCommand{});
+        std::vector<GLuint> drawMaterial(meshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            cmds[i].count = (GLuint)meshes[i].indexCount;
+            cmds[i].instanceCount = 1;
+            cmds[i].firstIndex = meshes[i].firstIndex;
+            cmds[i].baseVertex = (GLint)meshes[i].baseVertex;
+            cmds[i].baseInstance = (GLuint)i;
+            drawMaterial[i] = meshes[i].material;
+        }
+
+        // GKϨ̤ؤoզ texture arrayASSBO OC draw έӧBb@h
+        textureBuckets = buildMaterialTextureArrays(materials);
+        std::vector<GLuint> materialSlots(materials.size() * 2);
+        for (size_t i = 0; i < materials.size(); ++i) {
+            materialSlots[i * 2 + 0] = materials[i].bucket;
+            materialSlots[i * 2 + 1] = materials[i].layer;
+        }
+        glGenBuffers(1, &drawMaterialBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawMaterialBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, drawMaterial.size() * sizeof(GLuint), drawMaterial.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &materialBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, materialSlots.size() * sizeof(GLuint), materialSlots.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        // إߦ@ VAO / VBO / EBO / indirect buffer
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glGenBuffers(1, &indirectBuffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(Vertex), allVertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned), allIndices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+        glBindVertexArray(0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, cmds.size() * sizeof(DrawElementsIndirectCommand), cmds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        cpuPositions.resize(allVertices.size());
+        for (size_t i = 0; i < allVertices.size(); ++i) cpuPositions[i] = allVertices[i].pos;
+        cpuIndices = allIndices;
+
+        fprintf(stderr, "[Model] meshes=%zu materials=%zu buckets=%zu verts=%zu indices=%zu  AABB min(%.2f,%.2f,%.2f) max(%.2f,%.2f,%.2f)\n",
+            meshes.size(), materials.size(), textureBuckets.size(), allVertices.size(), allIndices.size(),
+            bmin.x, bmin.y, bmin.z, bmax.x, bmax.y, bmax.z);
     }
 
-    void draw() const { for (auto& m : meshes) m.draw(); }
+    // texture array jb unit 0..N-1Ajb SSBO 0/1
+    void bindMaterials(GlStateCache& state) const {
+        for (size_t b = 0; b < textureBuckets.size(); ++b)
+            state.bindTexture((GLuint)b, GL_TEXTURE_2D_ARRAY, textureBuckets[b]);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, drawMaterialBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, materialBuffer);
+    }
+
+    // iקj Textured / Normal ColorAӳO@ MultiDraw
+    void draw() const {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)meshes.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // isWjmodel matrix MwIs@Gmesh AABB  8 Ө world space A AABB
+    void buildBVH(const glm::mat4& modelMatrix) {
+        TRACE_SCOPE("Model::buildBVH");
+        std::vector<BvhAabb> worldBoxes(meshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            glm::vec3 wmin(std::numeric_limits<float>::infinity());
+            glm::vec3 wmax(-std::numeric_limits<float>::infinity());
+            for (int c = 0; c < 8; ++c) {
+                const glm::vec3 corner((c & 1) ? meshes[i].bmax.x : meshes[i].bmin.x,
+                                       (c & 2) ? meshes[i].bmax.y : meshes[i].bmin.y,
+                                       (c & 4) ? meshes[i].bmax.z : meshes[i].bmin.z);
+                const glm::vec3 w = glm::vec3(modelMatrix * glm::vec4(corner, 1.0f));
+                wmin = glm::min(wmin, w);
+                wmax = glm::max(wmax, w);
+            }
+            worldBoxes[i] = { wmin, wmax };
+        }
+        bvh.build(worldBoxes);
+
+        if (culledIndirectBuffer == 0) glGenBuffers(1, &culledIndirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culledIndirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, cmds.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        fprintf(stderr, "[Model] BVH nodes=%zu\n", bvh.nodes().size());
+    }
+
+    // isWjbuildBVH IsGD world AABB njBTΤh mesh BתA world space
+    void buildOccluders(const glm::mat4& modelMatrix, SoftwareOcclusion& occlusion) const {
+        TRACE_SCOPE("Model::buildOccluders");
+        std::vector<uint32_t> triangleCounts(meshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i) triangleCounts[i] = (uint32_t)meshes[i].indexCount / 3;
+        const std::vector<uint32_t> picked = SoftwareOcclusion::selectOccluders(bvh.boxes(), triangleCounts, 16, 4096);
+
+        occlusion.clearOccluders();
+        std::vector<glm::vec3> worldPositions;
+        std::vector<uint32_t> indices;
+        for (uint32_t m : picked) {
+            const GLMesh& mesh = meshes[m];
+            // index O۹ baseVertex Auഫo mesh Ψ쪺qI
+            indices.assign(cpuIndices.begin() + mesh.firstIndex, cpuIndices.begin() + mesh.firstIndex + mesh.indexCount);
+            const uint32_t vertexCount = *std::max_element(indices.begin(), indices.end()) + 1;
+            worldPositions.resize(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                worldPositions[v] = glm::vec3(modelMatrix * glm::vec4(cpuPositions[mesh.baseVertex + v], 1.0f));
+            occlusion.addOccluder(worldPositions, indices);
+        }
+        fprintf(stderr, "[Model] occluders=%zu triangles=%zu\n", picked.size(), occlusion.numOccluderTriangles());
+    }
+
+    // iקjue visible ̪ meshGi render queue  (program, VAO, `) ƧǡA
+    // P program / VAO @qX@ MultiDrawFbaseInstance ٬O쥻 draw indexAΧC
+    // 褣i keyGO shader  draw index dA|h@ bindAihu| BVH Ʀneᶶ
+    void drawVisible(const std::vector<uint32_t>& visible, GLuint program, const glm::vec3& eye,
+                     RenderQueue& queue, GlStateCache& state) {
+        if (visible.empty()) return;
+        const std::vector<BvhAabb>& boxes = bvh.boxes();
+        queue.clear();
+        for (uint32_t i : visible) {
+            const glm::vec3 center = (boxes[i].min + boxes[i].max) * 0.5f;
+            queue.push(program, vao, glm::length(center - eye), i);
+        }
+        {
+            TRACE_SCOPE("RenderQueue::sort");
+            queue.sort();
+        }
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culledIndirectBuffer);
+        // orphan W@V٦bΪeAקK GPU
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, cmds.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+        culledCmds.clear();
+        queue.submit(state, [&](const uint32_t* draws, size_t count) {
+            const size_t first = culledCmds.size();
+            for (size_t k = 0; k < count; ++k) culledCmds.push_back(cmds[draws[k]]);
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, first * sizeof(DrawElementsIndirectCommand),
+                count * sizeof(DrawElementsIndirectCommand), culledCmds.data() + first);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                (void*)(first * sizeof(DrawElementsIndirectCommand)), (GLsizei)count, 0);
+        });
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
 };
 
 
@@ -280,6 +667,63 @@ static GLuint gProgram_Abstraction = 0;
 static GLuint gProgram_Watercolor = 0;  
 static GLuint gProgram_Magnifier = 0;
 static GLuint gProgram_Bloom = 0;
+static GLuint gProgram_BloomPrefilter = 0;  // isWjbloom mip chainGG + Y@b
+static GLuint gProgram_BloomDownsample = 0; // isWjbloom mip chainGU
+static GLuint gProgram_BloomUpsample = 0;   // isWjbloom mip chainGW (additive)
+static GLuint gProgram_OcclusionBox = 0; // isWjocclusion query Ϊ AABB
+static GLuint gProgram_GBuffer = 0;          // isWjdeferred  geometry pass
+static GLuint gProgram_DeferredLighting = 0; // isWjdeferred  tiled  (compute)
+static GLuint gProgram_SSAO = 0;             // isWjCѪR SSAO (compute)
+static GLuint gProgram_SSAOUpsample = 0;     // isWjSSAO bilateral upsample (compute)
+
+// isWjۦ|G0 = Forward (clustered), 1 = Deferred (G-buffer + tiled compute)
+static int g_shadingPath = 0;
+
+// isWjSSAOGb 1/g_ssaoScale ѪR׺AA bilateral upsample ^C
+static bool g_ssaoEnabled = false;
+static int g_ssaoScale = 2;           // 2 = half res, 4 = quarter res
+static float g_ssaoRadius = 0.5f;     // world  (Yb| 6 k)
+static float g_ssaoStrength = 1.0f;
+static bool g_ssaoShowAO = false;
+static const int SSAO_KERNEL_SIZE = 16; // ssao_cs.glsl ̦h MAX_KERNEL_SIZE = 32
+static glm::vec3 g_ssaoKernel[SSAO_KERNEL_SIZE];
+static GLuint texSSAO = 0;            // rg16fGAO, uʲ`
+static int g_ssaoTexW = 0, g_ssaoTexH = 0;
+
+// isWjʺAѪRסGfbo ӵjptm (= ̤j)ACVueU scale dA
+// s pass j^ù (KUơA pp_common.glsl)Cscale ̤W@q쪺 GPU ɶվC
+struct DynamicResolution {
+    bool enabled = false;
+    float scale = 1.0f;
+    float minScale = 0.5f;
+    float targetMs = 14.5f;   // 60 Hz (16.7 ms) d@I ImGui / swap
+    float sharpness = 0.5f;   // scale = minScale ɪUƱjסAscale = 1 ɤU
+    int framesUntilUpdate = 0;
+
+    void update(double gpuMs) {
+        if (!enabled) { scale = 1.0f; return; }
+        if (gpuMs <= 0.0 || --framesUntilUpdate > 0) return;
+        framesUntilUpdate = GpuProfiler::FRAME_RING; // GnߴXV~Ūo^ӡAs˥A
+
+        // j򹳯 (scale^2) 
+        const float ideal = scale * sqrtf(targetMs / (float)gpuMs);
+        if (ideal < scale) scale = std::max(ideal, scale - 0.1f);                     // WɡGW
+        else if (gpuMs < targetMs * 0.85) scale = std::min(ideal, scale + 0.02f);    // lΡGCCɡAקKӦ^
+        scale = std::max(minScale, std::min(scale, 1.0f));
+    }
+
+    // oVڵejpA 8 pixel (compute pass  tile )
+    void renderSize(int width, int height, int& rw, int& rh) const {
+        rw = std::min(width, std::max(8, ((int)(width * scale) + 7) & ~7));
+        rh = std::min(height, std::max(8, ((int)(height * scale) + 7) & ~7));
+    }
+
+    float sharpenAmount() const {
+        if (!enabled || minScale >= 1.0f) return 0.0f;
+        return sharpness * (1.0f - scale) / (1.0f - minScale);
+    }
+};
+static DynamicResolution g_dynamicResolution;
 
 static GLuint g_NoiseTexture = 0;
 static glm::vec2 g_MousePosNormalized = glm::vec2(0.5f);
@@ -287,9 +731,527 @@ static glm::vec2 g_MousePosNormalized = glm::vec2(0.5f);
 // (FBO M Quad ܼơAAWwg[LF)
 static GLuint fbo = 0;
 static GLuint texColorBuffer = 0;
-static GLuint rboDepthStencil = 0;
+static GLuint texGAlbedo = 0;      // isWjG-bufferGCOLOR_ATTACHMENT1
+static GLuint texGNormal = 0;      // isWjG-bufferGCOLOR_ATTACHMENT2 (world-space ku)
+static GLuint texDepthStencil = 0; // iקj쥻O renderbufferAdeferred nŪ`שҥH令 texture
 static GLuint quadVAO = 0;
 static GLuint quadVBO = 0;
+static int g_fboW = 0; // isWjfbo ڰtmjp (>= A ensureFramebuffer)
+static int g_fboH = 0;
+
+// isWjs effect chainĢǮMΡAC@qiH襤G榡 (̫@qeù)
+struct PostFormat {
+    const char* name;
+    GLenum format;
+    const char* imageFormat; // compute  imageStore Ϊ layout 榡
+};
+static const PostFormat POST_FORMATS[] = {
+    { "RGBA8", GL_RGBA8, "rgba8" },
+    { "R11G11B10F", GL_R11F_G11F_B10F, "r11f_g11f_b10f" }, //  RGBA8 @ 32 bitAiHsWL 1 G
+    { "RGBA16F", GL_RGBA16F, "rgba16f" },
+};
+static const int NUM_POST_FORMATS = sizeof(POST_FORMATS) / sizeof(POST_FORMATS[0]);
+// isWjabstraction  compute  (shared memory tile)ACؿX榡Us@
+static GLuint gProgram_AbstractionCS[NUM_POST_FORMATS] = {};
+static bool g_postComputeBackend = true;
+static const int ABSTRACTION_CS_APRON = 8; // pp_cs_abstraction.glsl  APRONGshared memory uhŪoh pixel
+static const char* POST_EFFECT_NAMES[] = {
+    "None", "Image Abstraction", "Watercolor", "Magnifier", "Bloom Effect", "Pixelization", "Sine Wave",
+    "Tone Mapping", "Color Quantization"
+};
+// isWjĪG ( POST_EFFECT_NAMES P)G
+// FULL nŪ@F~Φh passAۤv@ programFREMAP u uvFCOLOR uC (point-wise)C
+// s REMAP / COLOR iHX֦@ pass ( FusedPostPrograms)
+enum PostEffectKind { POST_FULL, POST_REMAP, POST_COLOR };
+struct PostEffectFx {
+    PostEffectKind kind;
+    const char* file;     // fused shader n #include ɮ
+    const char* function; // REMAP: bool f(inout vec2 uv)FCOLOR: vec4 f(vec4 color)
+    const char* sceneDivisor; // isWjD null ɡAb chain Ĥ@qܳuݭn ù / oӰѼ ѪR
+};
+static const PostEffectFx POST_EFFECT_FX[] = {
+    { POST_COLOR, nullptr, nullptr, nullptr }, // None
+    { POST_FULL, nullptr, nullptr, nullptr },  // Image Abstraction
+    { POST_FULL, nullptr, nullptr, nullptr },  // Watercolor
+    { POST_REMAP, "pp_fx_magnifier.glsl", "fxMagnifier", nullptr },
+    { POST_FULL, nullptr, nullptr, nullptr },  // Bloom
+    { POST_REMAP, "pp_fx_pixelate.glsl", "fxPixelate", "uPixelSize" }, // Cu@ texel
+    { POST_REMAP, "pp_fx_sinewave.glsl", "fxSineWave", nullptr },
+    { POST_COLOR, "pp_fx_tonemap.glsl", "fxToneMap", nullptr },
+    { POST_COLOR, "pp_fx_quantize.glsl", "fxQuantize", nullptr },
+};
+static_assert(sizeof(POST_EFFECT_FX) / sizeof(POST_EFFECT_FX[0]) == sizeof(POST_EFFECT_NAMES) / sizeof(POST_EFFECT_NAMES[0]),
+    "POST_EFFECT_FX must match POST_EFFECT_NAMES");
+
+// isWjTemporal amortizationGabstraction / watercolor CVu 1 / g_temporalPeriod  16x16 tileA
+// L tile  on_display ۾x}qW@Vo@qX reproject LӡAXe disocclusion  tile 
+// (pp_temporal.glsl / pp_cs_temporal_reproject.glsl)Co@qeiۤvvAvNOo@qXC
+// iקj쥻v pixel DGwarp ̴XG@wn⪺ pixelA[WCViƻs depth-stencilAϦӤٺCC
+// {bƵ{H tile  (indirect draw / dispatch)AW@V`ץ reproject pass sbo@q r32f v
+static int g_temporalPeriod = 1; // 1 = A2 = ѽLA4 = 2x2 y
+static const int TEMPORAL_TILE = 16; //  pp_temporal.glsl  tile @ˤj
+struct TemporalHistory {
+    GLuint color[2] = {}, fbo[2] = {}; // ping-pongGW@Vb [current]AoVg [current ^ 1]
+    GLuint depth[2] = {};              // P@V` (r32f)Adisocclusion P_
+    int current = 0;
+    GLenum format = 0;
+    int width = 0, height = 0;     // tmjp
+    int usedWidth = 0, usedHeight = 0;
+    int effect = -1;
+    GLuint program = 0;            //  program / ѼƩ comparison bar ʤFAªGN reproject
+    std::vector<float> params;
+    bool comparison = false;
+    float barPosition = 0.0f;
+    glm::mat4 viewProj = glm::mat4(1.0f); // g [current] V۾
+    bool valid = false;
+};
+static std::vector<TemporalHistory> g_temporalHistory; //  chain ̲ĴX pass
+static unsigned g_temporalFrame = 0;
+static GLuint gProgram_TemporalReprojectCS[NUM_POST_FORMATS] = {}; // CؿX榡Us@
+static GLuint g_temporalTileBuffer = 0;     // oVn⪺ tile M (x | y << 16)
+static size_t g_temporalTileCapacity = 0;
+static GLuint g_temporalIndirectBuffer = 0; // DrawArraysIndirectCommand + DispatchIndirectCommand (offset 16)
+static GLuint g_temporalTileVAO = 0;        // quadVAO I + C instance @ tile M
+
+//  pass qvFjp render target pool @˨B榡o@qX@ (compute  imageStore i)C
+// ĪGBprogramBѼƩέstmɧ@oAoVNi
+static TemporalHistory& temporalHistoryFor(size_t pass, int effect, GLuint program, const std::vector<float>& params,
+    GLenum format, int w, int h) {
+    if (g_temporalHistory.size() <= pass) g_temporalHistory.resize(pass + 1);
+    TemporalHistory& t = g_temporalHistory[pass];
+    const int tw = RenderTargetPool::roundUp(w), th = RenderTargetPool::roundUp(h);
+    if (t.color[0] && (t.width != tw || t.height != th || t.format != format)) {
+        glDeleteFramebuffers(2, t.fbo);
+        glDeleteTextures(2, t.color);
+        glDeleteTextures(2, t.depth);
+        t.color[0] = 0;
+    }
+    if (!t.color[0]) {
+        for (int k = 0; k < 2; ++k) {
+            const GLenum formats[2] = { format, GL_R32F };
+            GLuint* textures[2] = { &t.color[k], &t.depth[k] };
+            for (int j = 0; j < 2; ++j) {
+                glGenTextures(1, textures[j]);
+                glBindTexture(GL_TEXTURE_2D, *textures[j]);
+                glTexStorage2D(GL_TEXTURE_2D, 1, formats[j], tw, th);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, j == 0 ? GL_LINEAR : GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, j == 0 ? GL_LINEAR : GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            }
+            glGenFramebuffers(1, &t.fbo[k]);
+            glBindFramebuffer(GL_FRAMEBUFFER, t.fbo[k]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.color[k], 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        t.format = format;
+        t.width = tw;
+        t.height = th;
+        t.valid = false;
+    }
+    if (t.effect != effect || t.program != program || t.params != params || t.usedWidth != w || t.usedHeight != h
+        || t.comparison != g_EnableComparisonBar || t.barPosition != g_BarPosition) {
+        t.effect = effect;
+        t.program = program;
+        t.params = params;
+        t.comparison = g_EnableComparisonBar;
+        t.barPosition = g_BarPosition;
+        t.valid = false;
+    }
+    return t;
+}
+
+// ĪGѼ (GUI i)Cspecialize = true  #define si shaderAj / kiHbsĶɺⱼA
+// F|zL ShaderPermutations s@sFfalse CV uniform 
+struct PostEffectParam {
+    int effect;       // POST_EFFECT_NAMES  index
+    const char* name; // #define  uniform Wr
+    const char* label;
+    bool specialize;
+    bool integer;     // ƤAGUI u
+    float value, minValue, maxValue;
+};
+static PostEffectParam g_postParams[] = {
+    // iקjs slider @ߥ uniformG@UNO@ӷs #define զXA|@bIs
+    { 1, "uAbstractionBlurSize", "Abstraction blur size", false, false, 1.0f / 512.0f, 1.0f / 2048.0f, 1.0f / 128.0f },
+    { 1, "ABSTRACTION_LEVELS", "Abstraction color levels", true, true, 8.0f, 2.0f, 16.0f },
+    { 1, "uAbstractionEdgeThreshold", "Abstraction edge threshold", false, false, 0.2f, 0.05f, 1.0f },
+    { 2, "WATERCOLOR_LEVELS", "Watercolor color levels", true, true, 6.0f, 2.0f, 16.0f },
+    { 2, "uNoiseStrength", "Watercolor distortion", false, false, 0.02f, 0.0f, 0.1f },
+    { 3, "uRadius", "Magnifier radius", false, false, 0.2f, 0.05f, 0.5f },
+    { 3, "uZoom", "Magnifier zoom", false, false, 2.0f, 1.0f, 8.0f },
+    { 4, "uBloomIntensity", "Bloom intensity", false, false, 3.5f, 0.0f, 8.0f },
+    { 5, "uPixelSize", "Pixel size", false, true, 16.0f, 2.0f, 64.0f },
+    { 6, "uPower1", "Sine amplitude", false, false, 0.02f, 0.0f, 0.1f },
+    { 6, "uPower2", "Sine frequency", false, false, 20.0f, 1.0f, 60.0f },
+    { 8, "QUANTIZE_LEVELS", "Quantization levels", true, true, 8.0f, 2.0f, 16.0f },
+};
+
+// oӮĪGثe #define զXAPɤ]O permutation key @
+static std::string postSpecializationDefines(int effect) {
+    std::string defines;
+    for (const PostEffectParam& p : g_postParams) {
+        if (p.effect != effect || !p.specialize) continue;
+        char buf[128];
+        snprintf(buf, sizeof(buf), "#define %s %.9g\n", p.name, p.integer ? std::round(p.value) : p.value);
+        std::string line = buf;
+        if (line.find_first_of(".e", line.find(p.name) + strlen(p.name)) == std::string::npos)
+            line.insert(line.size() - 1, ".0"); // GLSL float literal
+        defines += line;
+    }
+    return defines;
+}
+
+struct PostStage {
+    int effect; // POST_EFFECT_NAMES  index
+    int format; // POST_FORMATS  index
+};
+static std::vector<PostStage> g_postChain;
+static const size_t MAX_POST_STAGES = 8;
+static RenderTargetPool g_renderTargetPool;
+static bool g_postFusion = true;
+static int g_postPassCount = 0; // GUI ܥΡGoVڵeFX pass
+
+// ۤv .glsl ĪGFS (u pp_fx_*.glsl ) ^ 0A FusedPostPrograms 
+static GLuint postProgramOf(int effect) {
+    switch (effect) {
+        case 0: return gProgram_Passthrough;
+        case 1: // iקjiձ`ƪĪGq permutation ֨
+            return g_shaderPermutations.get("pp_fs_abstraction", postSpecializationDefines(1), gProgram_Abstraction, [] {
+                return startProgramBuild(loadShaderSource("shaders/pp_vs.glsl"),
+                    withDefines(loadShaderSource("shaders/pp_fs_abstraction.glsl"), postSpecializationDefines(1)));
+            });
+        case 2:
+            return g_shaderPermutations.get("pp_fs_watercolor", postSpecializationDefines(2), gProgram_Watercolor, [] {
+                return startProgramBuild(loadShaderSource("shaders/pp_vs.glsl"),
+                    withDefines(loadShaderSource("shaders/pp_fs_watercolor.glsl"), postSpecializationDefines(2)));
+            });
+        case 3: return gProgram_Magnifier;
+        case 4: return gProgram_Bloom;
+        case 5: return gProgram_Pixelate;
+        case 6: return gProgram_SineWave;
+        default: return 0;
+    }
+}
+
+// isWj@ REMAP / COLOR ĪGͦ@ fragment shaderAٱC@qùŪgC
+//  n qO REMAP  out_n(uv) = out_{n-1}(f_n(uv))AO COLOR  out_n(uv) = g_n(out_{n-1}(uv))A
+// ҥH uv Mgn˵ۮMAˤ@AAӶǮMCCsn program ήĪGǦC (+ #define)  key ֨_ӡC
+struct FusedPostPrograms {
+    static std::string signatureOf(const std::vector<int>& effects) {
+        std::string key;
+        for (int e : effects) key += std::to_string(e) + ",";
+        return key;
+    }
+
+    static std::string generateSource(const std::vector<int>& effects) {
+        std::string src =
+            "#version 410 core\n"
+            "#include \"pp_common.glsl\"\n"
+            "out vec4 FragColor;\n"
+            "in vec2 vUV;\n"
+            "uniform sampler2D uScreenTexture;\n"
+            "uniform bool uEnableComparison;\n"
+            "uniform float uBarPosition;\n"
+            "uniform float uBarWidth = 0.005;\n";
+        std::set<std::string> included;
+        for (int e : effects)
+            if (POST_EFFECT_FX[e].file && included.insert(POST_EFFECT_FX[e].file).second)
+                src += std::string("#include \"") + POST_EFFECT_FX[e].file + "\"\n";
+
+        src += "void main() {\n"
+               "    vec4 originalColor = sampleSceneSharpened(uScreenTexture, vUV);\n"
+               "    vec2 uv = vUV;\n"
+               "    bool inside = true;\n";
+        for (size_t i = effects.size(); i-- > 0;)
+            if (POST_EFFECT_FX[effects[i]].kind == POST_REMAP)
+                src += std::string("    inside = inside && ") + POST_EFFECT_FX[effects[i]].function + "(uv);\n";
+        src += "    vec4 effectColor = !inside ? vec4(0.0, 0.0, 0.0, 1.0)\n"
+               "        : (uv == vUV ? originalColor : sampleScene(uScreenTexture, uv));\n";
+        for (int e : effects)
+            if (POST_EFFECT_FX[e].kind == POST_COLOR && POST_EFFECT_FX[e].function)
+                src += std::string("    effectColor = ") + POST_EFFECT_FX[e].function + "(effectColor);\n";
+        src += "    vec4 finalColor = (uEnableComparison && vUV.x < uBarPosition) ? originalColor : effectColor;\n"
+               "    if (uEnableComparison && abs(vUV.x - uBarPosition) < uBarWidth * 0.5)\n"
+               "        finalColor = vec4(1.0, 0.0, 0.0, 1.0); // Red bar\n"
+               "    FragColor = finalColor;\n"
+               "}\n";
+        return src;
+    }
+
+    // Ĥ@ΨɦbIsAsne ( link ) ^ 0AbuildPostPasses |^@q@qe
+    GLuint get(const std::vector<int>& effects) {
+        std::set<int> unique(effects.begin(), effects.end());
+        std::string defines;
+        for (int e : unique) defines += postSpecializationDefines(e);
+        return g_shaderPermutations.get("fused " + signatureOf(effects), defines, 0, [&] {
+            TRACE_SCOPE("FusedPostPrograms::get");
+            return startProgramBuild(loadShaderSource("shaders/pp_vs.glsl"),
+                withDefines(expandShaderIncludes(generateSource(effects), "shaders/"), defines));
+        });
+    }
+};
+static FusedPostPrograms g_fusedPostPrograms;
+
+// @ӫs passG@ FULL ĪGAΦXְ_Ӫ@ REMAP / COLOR ĪG
+struct PostPass {
+    std::vector<int> effects;
+    int format; // X榡 = o̳̫@q榡
+    GLuint program;
+};
+
+// @qĪGۤv programGۤv .glsl ¥έ쥻AS (tone mapping / quantization) Υut
+// fused programF٦bs link ѴNe passthrough (ѷ|Cb GUI)A|q
+static GLuint singlePostProgram(int effect) {
+    if (GLuint program = postProgramOf(effect)) return program;
+    if (GLuint program = g_fusedPostPrograms.get({ effect })) return program;
+    return gProgram_Passthrough;
+}
+
+static std::vector<PostPass> buildPostPasses(const std::vector<PostStage>& chain, bool fuse) {
+    //  (chain  index)Gs REMAP / COLOR X@
+    std::vector<std::vector<size_t>> groups;
+    bool lastFusable = false;
+    for (size_t i = 0; i < chain.size(); ++i) {
+        const bool fusable = POST_EFFECT_FX[chain[i].effect].kind != POST_FULL;
+        if (fuse && fusable && lastFusable) groups.back().push_back(i);
+        else groups.push_back({ i });
+        lastFusable = fusable;
+    }
+
+    std::vector<PostPass> passes;
+    for (const std::vector<size_t>& group : groups) {
+        if (group.size() > 1) {
+            std::vector<int> effects;
+            for (size_t i : group) effects.push_back(chain[i].effect);
+            if (GLuint fused = g_fusedPostPrograms.get(effects)) {
+                passes.push_back(PostPass{ effects, chain[group.back()].format, fused });
+                continue;
+            }
+            // iקjX֪ program ٦bIs ( link )G^@q@q passA쥻|L
+        }
+        for (size_t i : group)
+            passes.push_back(PostPass{ { chain[i].effect }, chain[i].format, singlePostProgram(chain[i].effect) });
+    }
+    return passes;
+}
+
+// UĪGۤv uniform / texture (nb draw e]n)
+static void setupPostEffectUniforms(GLuint ppShader, int effect) {
+    if (effect == 2 && g_NoiseTexture != 0) { // Watercolor noise
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, g_NoiseTexture);
+        glUniform1i(glGetUniformLocation(ppShader, "uNoiseTexture"), 1);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    else if (effect == 3) { // Magnifier
+        glUniform2f(glGetUniformLocation(ppShader, "uMousePos"),
+            g_MousePosNormalized.x,
+            1.0f - g_MousePosNormalized.y); // <-- ½ Y
+    }
+    else if (effect == 6) { // Sine Wave
+        glUniform1f(glGetUniformLocation(ppShader, "uTime"), (float)glfwGetTime()); // oثeɶ
+    }
+    // iקj쥻TwǪ uRadius / uZoom / uPixelSize / uPower1 / uPower2 q g_postParams 
+    for (const PostEffectParam& p : g_postParams)
+        if (p.effect == effect && !p.specialize)
+            glUniform1f(glGetUniformLocation(ppShader, p.name), p.integer ? std::round(p.value) : p.value);
+}
+
+static float postParamValue(const char* name) {
+    for (const PostEffectParam& p : g_postParams)
+        if (strcmp(p.name, name) == 0) return p.value;
+    return 0.0f;
+}
+
+// oӮĪGҦѼƥثe (temporal vӧP_nni)
+static std::vector<float> postParamValues(int effect) {
+    std::vector<float> values;
+    for (const PostEffectParam& p : g_postParams)
+        if (p.effect == effect) values.push_back(p.value);
+    return values;
+}
+
+// isWjchain Ĥ@qĪGpGŧiF sceneDivisor (Ҧp pixelization Cu@ texel)A
+// e@@ pixelAsAήl (= texel ) ˩jA nearestC
+// Comparison bar }ۮɥnܭϡANӭ쥻ѪR׵eC
+static void postSceneResolution(int w, int h, int& rw, int& rh) {
+    if (g_postChain.empty() || g_EnableComparisonBar) return;
+    const char* divisor = POST_EFFECT_FX[g_postChain.front().effect].sceneDivisor;
+    if (!divisor) return;
+    const int cells = std::max(1, (int)std::round(postParamValue(divisor)));
+    rw = std::min(rw, (w + cells - 1) / cells);
+    rh = std::min(rh, (h + cells - 1) / cells);
+}
+
+// isWjĪGu|쪺d (pixelAUIA[x0, x1) x [y0, y1))C
+// Comparison bar ûOJ (ubĪG)Fju|ƹ񪺶C
+struct PostRect {
+    int x0, y0, x1, y1;
+    bool empty() const { return x1 <= x0 || y1 <= y0; }
+};
+static const float COMPARISON_BAR_WIDTH = 0.005f; //  pp_fs_*.glsl  uBarWidth w]Ȥ@
+
+static PostRect postActiveRect(int effect, int w, int h) {
+    PostRect r = { 0, 0, w, h };
+    if (g_EnableComparisonBar)
+        r.x0 = (int)std::floor((g_BarPosition - COMPARISON_BAR_WIDTH * 0.5f) * w);
+    if (effect == 3) { // MagnifierGuv ŶAb pixel ŶOA~x (hd 1 pixel)
+        const float radius = postParamValue("uRadius");
+        const glm::vec2 center(g_MousePosNormalized.x, 1.0f - g_MousePosNormalized.y);
+        r.x0 = std::max(r.x0, (int)std::floor((center.x - radius) * w) - 1);
+        r.x1 = std::min(r.x1, (int)std::ceil((center.x + radius) * w) + 1);
+        r.y0 = std::max(r.y0, (int)std::floor((center.y - radius) * h) - 1);
+        r.y1 = std::min(r.y1, (int)std::ceil((center.y + radius) * h) + 1);
+    }
+    r.x0 = std::max(r.x0, 0);
+    r.y0 = std::max(r.y0, 0);
+    return r;
+}
+
+// isWjĪGue active dALa (̦h 4 )  passthrough ƻsJC
+// ĪG program M uniform n]nFƻsuΦP@iJ (texture unit 0)Buv YPUơC
+// isWjtemporalTiles ɮĪGue temporal  tile M (g_temporalTileVAO + GL_DRAW_INDIRECT_BUFFER njnA
+// pp_vs.glsl @ instance @)Aƻsӱ`e
+static void drawPostRegions(const PostRect& active, int w, int h,
+    float uvScaleX, float uvScaleY, float sharpness, bool temporalTiles = false) {
+    auto drawEffect = [temporalTiles] {
+        if (temporalTiles) glDrawArraysIndirect(GL_TRIANGLE_STRIP, (void*)0);
+        else glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    };
+    if (active.x0 <= 0 && active.y0 <= 0 && active.x1 >= w && active.y1 >= h) {
+        drawEffect();
+        return;
+    }
+    glEnable(GL_SCISSOR_TEST);
+    if (!active.empty()) {
+        glScissor(active.x0, active.y0, active.x1 - active.x0, active.y1 - active.y0);
+        drawEffect();
+    }
+    glUseProgram(gProgram_Passthrough);
+    glUniform1i(glGetUniformLocation(gProgram_Passthrough, "uScreenTexture"), 0);
+    glUniform2f(glGetUniformLocation(gProgram_Passthrough, "uUVScale"), uvScaleX, uvScaleY);
+    glUniform1f(glGetUniformLocation(gProgram_Passthrough, "uSharpness"), sharpness);
+    glUniform1i(glGetUniformLocation(gProgram_Passthrough, "uTemporalPeriod"), 1); // ĪG٨Ssn temporal qiNO passthrough
+    glUniform1i(glGetUniformLocation(gProgram_Passthrough, "uEnableComparison"), g_EnableComparisonBar ? 1 : 0); // uibo@
+    glUniform1f(glGetUniformLocation(gProgram_Passthrough, "uBarPosition"), g_BarPosition);
+    const PostRect a = active.empty() ? PostRect{ 0, 0, 0, 0 } : active;
+    const PostRect bands[4] = {
+        { 0, 0, w, a.y0 },        // U
+        { 0, a.y1, w, h },        // W
+        { 0, a.y0, a.x0, a.y1 },  // 
+        { a.x1, a.y0, w, a.y1 },  // k
+    };
+    for (const PostRect& b : bands) {
+        if (b.empty()) continue;
+        glScissor(b.x0, b.y0, b.x1 - b.x0, b.y1 - b.y0);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    glDisable(GL_SCISSOR_TEST);
+}
+
+// isWjtemporal amortization  reproject pass (pp_cs_temporal_reproject.glsl)GS쪺 tile reproject i
+// color[current ^ 1]AsoV`סAƥXn⪺ tile MM indirect ѼơCdepthTexture / depthUVScale OoV`
+static void temporalReproject(TemporalHistory& t, int format, GLuint depthTexture, const glm::vec2& depthUVScale,
+    const glm::mat4& viewProj, const glm::vec3& cameraPos, int w, int h) {
+    const int tilesX = (w + TEMPORAL_TILE - 1) / TEMPORAL_TILE, tilesY = (h + TEMPORAL_TILE - 1) / TEMPORAL_TILE;
+    const size_t tiles = (size_t)tilesX * tilesY;
+    if (g_temporalTileCapacity < tiles) { // M̦hC tile @
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_temporalTileBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tiles * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        g_temporalTileCapacity = tiles;
+    }
+    const GLuint reset[8] = { 4, 0, 0, 0, 0, 1, 1, 0 }; // 4 ӳI strip x 0  instanceF0 x 1 x 1  work group
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_temporalIndirectBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(reset), reset);
+
+    const int read = t.current, write = t.current ^ 1;
+    const GLuint program = gProgram_TemporalReprojectCS[format];
+    const glm::mat4 invViewProj = glm::inverse(viewProj);
+    const glm::mat4 prevInvViewProj = glm::inverse(t.viewProj);
+    glUseProgram(program);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, t.color[read]);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_2D, t.depth[read]);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(program, "uHistory"), 3);
+    glUniform1i(glGetUniformLocation(program, "uDepth"), 4);
+    glUniform1i(glGetUniformLocation(program, "uPrevDepth"), 5);
+    glUniform2f(glGetUniformLocation(program, "uHistoryUVScale"), (float)t.usedWidth / (float)t.width, (float)t.usedHeight / (float)t.height);
+    glUniform2f(glGetUniformLocation(program, "uDepthUVScale"), depthUVScale.x, depthUVScale.y);
+    glUniformMatrix4fv(glGetUniformLocation(program, "uInvViewProj"), 1, GL_FALSE, &invViewProj[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(program, "uPrevViewProj"), 1, GL_FALSE, &t.viewProj[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(program, "uPrevInvViewProj"), 1, GL_FALSE, &prevInvViewProj[0][0]);
+    glUniform3fv(glGetUniformLocation(program, "uCameraPos"), 1, &cameraPos[0]);
+    glUniform2i(glGetUniformLocation(program, "uOutputSize"), w, h);
+    glUniform1i(glGetUniformLocation(program, "uHistoryValid"), t.valid ? 1 : 0);
+    glUniform1i(glGetUniformLocation(program, "uTemporalPeriod"), g_temporalPeriod);
+    glUniform1i(glGetUniformLocation(program, "uTemporalPhase"), (int)(g_temporalFrame % g_temporalPeriod));
+    // comparison bar OϡACVnۿJܡFubĪG
+    const int recomputeBelowX = g_EnableComparisonBar ? (int)std::ceil((g_BarPosition + COMPARISON_BAR_WIDTH * 0.5f) * w) : 0;
+    glUniform1i(glGetUniformLocation(program, "uRecomputeBelowX"), recomputeBelowX);
+    glBindImageTexture(0, t.color[write], 0, GL_FALSE, 0, GL_WRITE_ONLY, t.format);
+    glBindImageTexture(1, t.depth[write], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, g_temporalTileBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, g_temporalIndirectBuffer);
+    glDispatchCompute(tilesX, tilesY, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT
+        | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+// isWjBloom  mip chainG1/2  1/4 UҽkAA@h@h tent upsample V^hC
+// ^ǳ̤Wh (1/2 ѪR)  pp_fs_bloom XAΧnٵ poolCquadVAO njnC
+// iקj쥻 1/8 ӥBChvۥ[AwjOª 7 px uʰI 3 eC
+// {bu 1/4AU@huV BLOOM_UPSAMPLE_WEIGHT iӡAdªth (CpuPostEffects L)C
+static const int BLOOM_LEVELS = 2;
+static const float BLOOM_UPSAMPLE_WEIGHT = 0.2f;
+static RenderTarget* renderBloomMipChain(GLuint input, float uvScaleX, float uvScaleY, int w, int h) {
+    if (!gProgram_BloomPrefilter || !gProgram_BloomDownsample || !gProgram_BloomUpsample) return nullptr;
+    RenderTarget* levels[BLOOM_LEVELS];
+    for (int i = 0; i < BLOOM_LEVELS; ++i) {
+        const int shift = i + 1;
+        levels[i] = g_renderTargetPool.acquire(std::max(1, w >> shift), std::max(1, h >> shift), GL_R11F_G11F_B10F);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    for (int i = 0; i < BLOOM_LEVELS; ++i) {
+        const GLuint program = i == 0 ? gProgram_BloomPrefilter : gProgram_BloomDownsample;
+        glBindFramebuffer(GL_FRAMEBUFFER, levels[i]->fbo);
+        glViewport(0, 0, levels[i]->usedWidth, levels[i]->usedHeight);
+        glUseProgram(program);
+        glBindTexture(GL_TEXTURE_2D, i == 0 ? input : levels[i - 1]->texture);
+        glUniform1i(glGetUniformLocation(program, "uScreenTexture"), 0);
+        if (i == 0)
+            glUniform2f(glGetUniformLocation(program, "uUVScale"), uvScaleX, uvScaleY);
+        else
+            glUniform2f(glGetUniformLocation(program, "uUVScale"), levels[i - 1]->uvScaleX(), levels[i - 1]->uvScaleY());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    // dst * (1 - w) + upsample * w
+    glEnable(GL_BLEND);
+    glBlendColor(0.0f, 0.0f, 0.0f, BLOOM_UPSAMPLE_WEIGHT);
+    glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+    glUseProgram(gProgram_BloomUpsample);
+    glUniform1i(glGetUniformLocation(gProgram_BloomUpsample, "uScreenTexture"), 0);
+    for (int i = BLOOM_LEVELS - 2; i >= 0; --i) {
+        glBindFramebuffer(GL_FRAMEBUFFER, levels[i]->fbo);
+        glViewport(0, 0, levels[i]->usedWidth, levels[i]->usedHeight);
+        glBindTexture(GL_TEXTURE_2D, levels[i + 1]->texture);
+        glUniform2f(glGetUniformLocation(gProgram_BloomUpsample, "uUVScale"), levels[i + 1]->uvScaleX(), levels[i + 1]->uvScaleY());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    glDisable(GL_BLEND);
+
+    for (int i = 1; i < BLOOM_LEVELS; ++i)
+        g_renderTargetPool.release(levels[i]);
+    return levels[0];
+}
 
 static Model gSponza;
 static glm::mat4 gProj, gView, gModel;
@@ -304,12 +1266,323 @@ struct FPSCamera {
     double lastX = 0.0, lastY = 0.0;
 } cam;
 
+// =====================================================================
+// isWjw occlusion query + conditional render
+// C mesh bee@ۤv world AABB (gC/`)  queryA
+// U@V glBeginConditionalRender(QUERY_NO_WAIT) YW@VGACPU ε GPUC
+// query  3 սyΡGoVoBW@V ( conditional render)B󦭪 (CPU DPBŪ^ hysteresis)
+// =====================================================================
+static const int OCCLUSION_RING = 3;
+static const long long OCCLUSION_HYSTERESIS = 4;   // ݱo줧ܤ֦ALeXVAקKSXӪ mesh {{
+static const float OCCLUSION_EYE_MARGIN = 0.25f;   // ۾b AABB  (t near plane jp)  query iH
+
+struct OcclusionCuller {
+    size_t meshCount = 0;
+    std::vector<GLuint> queries;             // [slot * meshCount + mesh]
+    std::vector<long long> issuedFrame;      // o query O@VoA-1 = So
+    std::vector<char> pendingRead;           // CPU ٨SŪLG
+    std::vector<long long> lastVisibleFrame; // CPU Ū^G̫@ݱo쪺V
+    std::vector<char> lastResult;            // CPU Ū^̷sG (έp)
+    std::vector<long long> lastResultFrame;  // lastResult O@Vo queryAªG\s
+    long long frame = 0;
+    GLuint boxVAO = 0, boxVBO = 0, boxEBO = 0;
+
+    // έp
+    int drawnUnconditional = 0;
+    int drawnConditional = 0;
+    int knownOccluded = 0;
+
+    void init(size_t count) {
+        meshCount = count;
+        queries.assign(OCCLUSION_RING * count, 0);
+        glGenQueries((GLsizei)queries.size(), queries.data());
+        issuedFrame.assign(queries.size(), -1);
+        pendingRead.assign(queries.size(), 0);
+        lastVisibleFrame.assign(count, -1000);
+        lastResult.assign(count, 1);
+        lastResultFrame.assign(count, -1);
+
+        // ߤ [0,1]^3Ashader A uBoxMin/uBoxMax }
+        const float corners[] = {
+            0,0,0, 1,0,0, 0,1,0, 1,1,0, 0,0,1, 1,0,1, 0,1,1, 1,1,1
+        };
+        const unsigned int indices[] = {
+            0,2,1, 1,2,3,  4,5,6, 5,7,6,  0,1,4, 1,5,4,
+            2,6,3, 3,6,7,  0,4,2, 2,4,6,  1,3,5, 3,7,5
+        };
+        glGenVertexArrays(1, &boxVAO);
+        glGenBuffers(1, &boxVBO);
+        glGenBuffers(1, &boxEBO);
+        glBindVertexArray(boxVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, boxVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boxEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glBindVertexArray(0);
+    }
+
+    // Ū^wgnG ()CqoVnΪ slot (ª) }lsŪA
+    // Ϊ slot ]nŪGoOQ\e̫@|
+    void collect() {
+        for (int k = 0; k < OCCLUSION_RING; ++k) {
+            const int slot = (int)((frame + k) % OCCLUSION_RING);
+            for (size_t i = 0; i < meshCount; ++i) {
+                const size_t q = slot * meshCount + i;
+                if (!pendingRead[q]) continue;
+                GLuint available = 0;
+                glGetQueryObjectuiv(queries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) continue;
+                GLuint anySamples = 0;
+                glGetQueryObjectuiv(queries[q], GL_QUERY_RESULT, &anySamples);
+                pendingRead[q] = 0;
+                if (issuedFrame[q] > lastResultFrame[i]) { // s slot iªn
+                    lastResult[i] = anySamples ? 1 : 0;
+                    lastResultFrame[i] = issuedFrame[q];
+                }
+                if (anySamples) lastVisibleFrame[i] = std::max(lastVisibleFrame[i], issuedFrame[q]);
+            }
+        }
+    }
+
+    static bool eyeInside(const BvhAabb& b, const glm::vec3& eye) {
+        const glm::vec3 lo = b.min - OCCLUSION_EYE_MARGIN, hi = b.max + OCCLUSION_EYE_MARGIN;
+        return eye.x >= lo.x && eye.y >= lo.y && eye.z >= lo.z &&
+               eye.x <= hi.x && eye.y <= hi.y && eye.z <= hi.z;
+    }
+
+    // visible = @簣 (Ѫ컷)  meshF shader / n]n
+    void drawScene(Model& model, const std::vector<uint32_t>& visible, const glm::mat4& viewProj, const glm::vec3& eye) {
+        if (queries.empty()) init(model.meshes.size());
+        collect();
+
+        const int curSlot = (int)(frame % OCCLUSION_RING);
+        const int prevSlot = (int)((frame + OCCLUSION_RING - 1) % OCCLUSION_RING);
+        const std::vector<BvhAabb>& boxes = model.bvh.boxes();
+        drawnUnconditional = drawnConditional = knownOccluded = 0;
+
+        // 1. e meshG̪ݱoB۾bl̡BΤW@VSLeAL浹 conditional render
+        glBindVertexArray(model.vao);
+        for (uint32_t i : visible) {
+            const DrawElementsIndirectCommand& c = model.cmds[i];
+            const size_t prevQuery = prevSlot * meshCount + i;
+            const bool recent = (frame - lastVisibleFrame[i]) <= OCCLUSION_HYSTERESIS;
+            const bool tested = issuedFrame[prevQuery] == frame - 1;
+            if (!lastResult[i]) knownOccluded++;
+
+            const bool conditional = tested && !recent && !eyeInside(boxes[i], eye);
+            if (conditional) glBeginConditionalRender(queries[prevQuery], GL_QUERY_NO_WAIT);
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, (GLsizei)c.count, GL_UNSIGNED_INT,
+                (void*)(c.firstIndex * sizeof(GLuint)), 1, c.baseVertex, c.baseInstance);
+            if (conditional) {
+                glEndConditionalRender();
+                drawnConditional++;
+            }
+            else {
+                drawnUnconditional++;
+            }
+        }
+
+        // 2. γoV`״C mesh  AABBAGU@V
+        GLint prevProgram = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
+        glUseProgram(gProgram_OcclusionBox);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_OcclusionBox, "uVP"), 1, GL_FALSE, &viewProj[0][0]);
+        const GLint locMin = glGetUniformLocation(gProgram_OcclusionBox, "uBoxMin");
+        const GLint locMax = glGetUniformLocation(gProgram_OcclusionBox, "uBoxMax");
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        glBindVertexArray(boxVAO);
+        for (uint32_t i : visible) {
+            if (eyeInside(boxes[i], eye)) continue; // ϥ|e
+            const size_t q = curSlot * meshCount + i;
+            // BaOoث mesh  AABB |ۤv|AyLjקKQۤvצ
+            const glm::vec3 boxMin = boxes[i].min - 0.01f, boxMax = boxes[i].max + 0.01f;
+            glUniform3fv(locMin, 1, &boxMin[0]);
+            glUniform3fv(locMax, 1, &boxMax[0]);
+            glBeginQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, queries[q]);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            glEndQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE);
+            issuedFrame[q] = frame;
+            pendingRead[q] = 1;
+        }
+        glBindVertexArray(0);
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glUseProgram(prevProgram);
+
+        frame++;
+    }
+};
+static OcclusionCuller g_occlusion;
+
+// isWjClustered forward lightingG
+// 1. cluster_build_cs ̧vx}@ CLUSTER_X * CLUSTER_Y * CLUSTER_Z  froxel (ubv / ܮ)
+// 2. cluster_cull_cs CVi froxel (C̦h MAX_LIGHTS_PER_CLUSTER )
+// 3. scene_fs u]ۤv檺AҥHC pixel 񪺥KצA`ƵL
+struct ClusteredLighting {
+    static const unsigned CLUSTER_X = 16, CLUSTER_Y = 9, CLUSTER_Z = 24;
+    static const unsigned CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+    static const unsigned MAX_LIGHTS_PER_CLUSTER = 128; // n cluster_cull_cs / scene_fs @
+    static const int MAX_LIGHTS = 1024;
+
+    // std430GT vec4
+    struct Light {
+        glm::vec4 posRadius;   // world-space m, vTb|
+        glm::vec4 colorType;   // rgb, w: 0 = point, 1 = spot
+        glm::vec4 spotDirCos;  // world-space V, cos(~)
+    };
+
+    GLuint buildProgram = 0, cullProgram = 0;
+    GLuint lightBuffer = 0, aabbBuffer = 0, countBuffer = 0, indexBuffer = 0;
+    std::vector<Light> lights;
+    int lightCount = 256;
+    glm::vec3 sceneMin = glm::vec3(-1.0f), sceneMax = glm::vec3(1.0f); // d (world)
+    float clusterNear = 0.1f, clusterFar = 30.0f, projFar = 5000.0f;
+
+    // W froxel ɪvPAܤF~
+    glm::mat4 builtProj = glm::mat4(0.0f);
+    int builtW = 0, builtH = 0;
+
+    void init() {
+        buildProgram = buildComputeProgramFromFile("shaders/cluster_build_cs.glsl");
+        cullProgram = buildComputeProgramFromFile("shaders/cluster_cull_cs.glsl");
+        glGenBuffers(1, &lightBuffer);
+        glGenBuffers(1, &aabbBuffer);
+        glGenBuffers(1, &countBuffer);
+        glGenBuffers(1, &indexBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, MAX_LIGHTS * sizeof(Light), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, aabbBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT * 2 * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // b world AABB UbH count ӥ (Tw seedACG@)A 1/4 O¤U spot
+    void generateLights(const glm::vec3& worldMin, const glm::vec3& worldMax, int count) {
+        sceneMin = worldMin;
+        sceneMax = worldMax;
+        lightCount = std::max(0, std::min(count, MAX_LIGHTS));
+        lights.resize(lightCount);
+        const glm::vec3 extent = worldMax - worldMin;
+        const float sceneSize = glm::length(extent);
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+        for (Light& l : lights) {
+            const glm::vec3 p = worldMin + extent * glm::vec3(u01(rng), 0.05f + 0.5f * u01(rng), u01(rng));
+            const float radius = sceneSize * (0.04f + 0.06f * u01(rng));
+            // MHCG@ӤqC
+            glm::vec3 c(u01(rng), u01(rng), u01(rng));
+            c[(int)(u01(rng) * 2.999f)] *= 0.2f;
+            const bool spot = u01(rng) < 0.25f;
+            l.posRadius = glm::vec4(p, radius);
+            l.colorType = glm::vec4(c * 2.0f, spot ? 1.0f : 0.0f);
+            l.spotDirCos = glm::vec4(0.0f, -1.0f, 0.0f, cosf(glm::radians(25.0f + 20.0f * u01(rng))));
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightBuffer);
+        if (!lights.empty())
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, lights.size() * sizeof(Light), lights.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // CVb scene pass eIsFnear / far qvx}ϱ
+    void update(const glm::mat4& P, const glm::mat4& V, int width, int height) {
+        TRACE_SCOPE("ClusteredLighting::update");
+        if (P != builtProj || width != builtW || height != builtH) {
+            const float a = P[2][2], b = P[3][2];
+            clusterNear = b / (a - 1.0f);
+            projFar = b / (a + 1.0f);
+            clusterFar = std::min(projFar, clusterNear * 300.0f);
+
+            glUseProgram(buildProgram);
+            glUniform3ui(glGetUniformLocation(buildProgram, "uClusterGrid"), CLUSTER_X, CLUSTER_Y, CLUSTER_Z);
+            glUniformMatrix4fv(glGetUniformLocation(buildProgram, "uInvP"), 1, GL_FALSE, &glm::inverse(P)[0][0]);
+            glUniform1f(glGetUniformLocation(buildProgram, "uClusterNear"), clusterNear);
+            glUniform1f(glGetUniformLocation(buildProgram, "uClusterFar"), clusterFar);
+            glUniform1f(glGetUniformLocation(buildProgram, "uProjFar"), projFar);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, aabbBuffer);
+            glDispatchCompute((CLUSTER_COUNT + 63) / 64, 1, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            builtProj = P; builtW = width; builtH = height;
+        }
+
+        glUseProgram(cullProgram);
+        glUniformMatrix4fv(glGetUniformLocation(cullProgram, "uV"), 1, GL_FALSE, &V[0][0]);
+        glUniform1ui(glGetUniformLocation(cullProgram, "uLightCount"), (GLuint)lightCount);
+        glUniform1ui(glGetUniformLocation(cullProgram, "uClusterCount"), CLUSTER_COUNT);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, lightBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, aabbBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, countBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, indexBuffer);
+        glDispatchCompute((CLUSTER_COUNT + 63) / 64, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    // scene shader wg useProgram Is
+    void bind(GLuint program, bool enabled, bool showHeat, int width, int height) const {
+        glUniform1i(glGetUniformLocation(program, "uClusteredLights"), enabled ? 1 : 0);
+        glUniform1i(glGetUniformLocation(program, "uShowClusterHeat"), showHeat ? 1 : 0);
+        if (!enabled) return;
+        glUniform3ui(glGetUniformLocation(program, "uClusterGrid"), CLUSTER_X, CLUSTER_Y, CLUSTER_Z);
+        glUniform2f(glGetUniformLocation(program, "uViewportSize"), (float)width, (float)height);
+        glUniform1f(glGetUniformLocation(program, "uClusterNear"), clusterNear);
+        glUniform1f(glGetUniformLocation(program, "uClusterFar"), clusterFar);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, lightBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, countBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, indexBuffer);
+    }
+};
+static ClusteredLighting g_clustered;
+static bool g_clusteredLightsEnabled = true;
+static bool g_showClusterHeat = false;
+
+// isWjby kernelG˥߶ (񪺾Bפn)ATw seed
+static void initSSAOKernel() {
+    std::mt19937 rng(4321u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    for (int i = 0; i < SSAO_KERNEL_SIZE; ++i) {
+        glm::vec3 s(u01(rng) * 2.0f - 1.0f, u01(rng) * 2.0f - 1.0f, u01(rng));
+        s = glm::normalize(s) * u01(rng);
+        const float t = (float)i / (float)SSAO_KERNEL_SIZE;
+        s *= 0.1f + 0.9f * t * t;
+        g_ssaoKernel[i] = s;
+    }
+}
+
+// isWjAO texture jp۵P g_ssaoScaleAܤF~
+static void ensureSSAOTexture(int width, int height) {
+    const int aw = (width + g_ssaoScale - 1) / g_ssaoScale;
+    const int ah = (height + g_ssaoScale - 1) / g_ssaoScale;
+    if (texSSAO && aw == g_ssaoTexW && ah == g_ssaoTexH) return;
+    if (texSSAO) glDeleteTextures(1, &texSSAO);
+    glGenTextures(1, &texSSAO);
+    glBindTexture(GL_TEXTURE_2D, texSSAO);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG16F, aw, ah);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    g_ssaoTexW = aw;
+    g_ssaoTexH = ah;
+}
+
 static void createFramebuffer(int width, int height) {
     // pG FBO wsbARª
     if (fbo) {
         glDeleteFramebuffers(1, &fbo);
         glDeleteTextures(1, &texColorBuffer);
-        glDeleteRenderbuffers(1, &rboDepthStencil);
+        glDeleteTextures(1, &texGAlbedo);
+        glDeleteTextures(1, &texGNormal);
+        glDeleteTextures(1, &texDepthStencil);
     }
 
     // 1. إ FBO
@@ -317,20 +1590,45 @@ static void createFramebuffer(int width, int height) {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
     // 2. إC⯾z (Color Texture)
+    // iקjRGBA8Gdeferred  imageStore gi (image load/store 䴩 RGB8)
     glGenTextures(1, &texColorBuffer);
     glBindTexture(GL_TEXTURE_2D, texColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texColorBuffer, 0);
 
-    // 3. إ߲`/ҪO Renderbuffer (RBO)
-    glGenRenderbuffers(1, &rboDepthStencil);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboDepthStencil);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboDepthStencil);
+    // isWjG-bufferGalbedo / kuA pass  texelFetch ŪAҥH NEAREST
+    const struct { GLuint* tex; GLenum internalFormat, format, type, attachment; } gbuffer[] = {
+        { &texGAlbedo, GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT1 },
+        { &texGNormal, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT,    GL_COLOR_ATTACHMENT2 },
+    };
+    for (const auto& g : gbuffer) {
+        glGenTextures(1, g.tex);
+        glBindTexture(GL_TEXTURE_2D, *g.tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, g.internalFormat, width, height, 0, g.format, g.type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, g.attachment, GL_TEXTURE_2D, *g.tex, 0);
+    }
+
+    // 3. إ߲`/ҪO Texture
+    glGenTextures(1, &texDepthStencil);
+    glBindTexture(GL_TEXTURE_2D, texDepthStencil);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+    glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, texDepthStencil, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // `ue COLOR_ATTACHMENT0Adeferred  geometry pass ~ G-buffer
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
 
     // 4. ˬd FBO O_
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
@@ -340,10 +1638,20 @@ static void createFramebuffer(int width, int height) {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+// isWj즲خɨCV|iӡAfbo ub񤣤Uɤ~ (@ RenderTargetPool l)A
+// Ypγ̤p (0x0) uέ쥻AeɭԥuΥU
+static void ensureFramebuffer(int width, int height) {
+    if (width <= 0 || height <= 0) return;
+    if (fbo && width <= g_fboW && height <= g_fboH) return;
+    g_fboW = std::max(g_fboW, RenderTargetPool::roundUp(width));
+    g_fboH = std::max(g_fboH, RenderTargetPool::roundUp(height));
+    createFramebuffer(g_fboW, g_fboH);
+}
+
 // isWjjpܪ^I
 static void on_framebuffer_size_changed(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
-    createFramebuffer(width, height); //  FBO
+    ensureFramebuffer(width, height); // iקj񤣤U~ FBO
 }
 
 static void updateCamera(GLFWwindow* window, float dt) {
@@ -396,6 +1704,7 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
 // bA on_display() 令䴩`רøsG
 void on_display()
 {
+    TRACE_SCOPE("on_display");
     int w, h;
     glfwGetFramebufferSize(glfwGetCurrentContext(), &w, &h);
 
@@ -415,20 +1724,41 @@ void on_display()
     glm::vec3 up = glm::normalize(glm::cross(right, forward));
     glm::mat4 V = glm::lookAt(cam.pos, cam.pos + forward, up);
 
+    // isWjʺAѪRסGrw x rh OoVڵejp (fbo U)Aw x h Où
+    if (g_gpuProfiler.enabled())
+        g_dynamicResolution.update(g_gpuProfiler.lastMs("gpu_frame"));
+    int rw, rh;
+    g_dynamicResolution.renderSize(w, h, rw, rh);
+    postSceneResolution(w, h, rw, rh); // isWjpixelization uݭnCѪRת
+    GpuProfiler::Scope frameScope(g_gpuProfiler, "gpu_frame"); //  + s (t ImGui)
+
+    const bool deferred = g_shadingPath == 1 && g_sceneRenderMode == 0;
+    const bool clustered = g_clusteredLightsEnabled && g_sceneRenderMode == 0 && !deferred;
+    if (clustered) {
+        GpuProfiler::Scope scope(g_gpuProfiler, "cluster");
+        g_clustered.update(P, V, rw, rh);
+    }
+
     // ------------------------------------------
     // --- Pass 1: Scene Pass (V FBO) ---
     // ------------------------------------------
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    glViewport(0, 0, w, h);
+    glViewport(0, 0, rw, rh);
+    const int scenePass = g_gpuProfiler.begin("scene");
 
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
+    if (deferred) {
+        // geometry pass ug albedo / kuFalbedo MIAɨSX󪺦a誽X
+        const GLenum gbufferTargets[] = { GL_NONE, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+        glDrawBuffers(3, gbufferTargets);
+    }
     glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // M FBO
 
     GLuint sceneShader;
     if (g_sceneRenderMode == 0) {
-        sceneShader = gProgram;
+        sceneShader = deferred ? gProgram_GBuffer : gProgram;
     }
     else {
         sceneShader = gProgram_NormalColor;
@@ -438,17 +1768,113 @@ void on_display()
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         return;
     }
-    glUseProgram(sceneShader);
+    // post pass / ImGui | GL AACVqYO
+    g_glState.invalidate();
+    g_glState.resetStats();
+    g_glState.useProgram(sceneShader);
 
     glUniformMatrix4fv(glGetUniformLocation(sceneShader, "uP"), 1, GL_FALSE, &P[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(sceneShader, "uV"), 1, GL_FALSE, &V[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(sceneShader, "uM"), 1, GL_FALSE, &gModel[0][0]);
     if (g_sceneRenderMode == 0) {
-        glUniform1i(glGetUniformLocation(sceneShader, "uTex0"), 0);
+        static const GLint bucketUnits[MAX_TEXTURE_BUCKETS] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        glUniform1iv(glGetUniformLocation(sceneShader, "uBucket"), MAX_TEXTURE_BUCKETS, bucketUnits);
+        if (!deferred) g_clustered.bind(sceneShader, clustered, g_showClusterHeat, rw, rh);
     }
+    gSponza.bindMaterials(g_glState); // scene_vs ؼҦ|Ū
 
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    gSponza.draw();
+    if (g_cullMode != 0) {
+        glm::vec4 planes[6];
+        SceneBVH::extractFrustumPlanes(P * V, planes);
+        {
+            TRACE_SCOPE("cullFrustum");
+            gSponza.bvh.cullFrustum(planes, cam.pos, g_visibleMeshes);
+        }
+        g_inFrustumCount = g_visibleMeshes.size();
+        if (g_cullMode == 2) {
+            TRACE_SCOPE("occlusionCull");
+            g_occlusion.drawScene(gSponza, g_visibleMeshes, P * V, cam.pos);
+        }
+        else {
+            if (g_cullMode == 3) {
+                // BתeiCѪR 1/w depthA@ѤU AABB Av@ (ǤܡA٬OѪ컷)
+                TRACE_SCOPE("softwareOcclusion");
+                g_softwareOcclusion.render(P * V);
+                g_softwareOcclusion.filterVisible(gSponza.bvh.boxes(), g_visibleMeshes);
+            }
+            g_renderQueue.setSortByState(g_sortDrawsByState);
+            gSponza.drawVisible(g_visibleMeshes, sceneShader, cam.pos, g_renderQueue, g_glState);
+            g_glState.bindVertexArray(0);
+        }
+    }
+    else {
+        gSponza.draw();
+        g_visibleMeshes.clear();
+    }
+    g_gpuProfiler.end(scenePass);
+
+    // isWjDeferredG16x16 tile  compute AGgi texColorBufferApost pass Ū
+    if (deferred) {
+        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+        GpuProfiler::Scope scope(g_gpuProfiler, "deferred_lighting");
+        const glm::mat4 invP = glm::inverse(P), invV = glm::inverse(V);
+        g_glState.useProgram(gProgram_DeferredLighting);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_DeferredLighting, "uInvP"), 1, GL_FALSE, &invP[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_DeferredLighting, "uV"), 1, GL_FALSE, &V[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_DeferredLighting, "uInvV"), 1, GL_FALSE, &invV[0][0]);
+        glUniform2i(glGetUniformLocation(gProgram_DeferredLighting, "uRenderSize"), rw, rh);
+        glUniform1ui(glGetUniformLocation(gProgram_DeferredLighting, "uLightCount"), (GLuint)g_clustered.lightCount);
+        glUniform1i(glGetUniformLocation(gProgram_DeferredLighting, "uLocalLights"), g_clusteredLightsEnabled ? 1 : 0);
+        glUniform1i(glGetUniformLocation(gProgram_DeferredLighting, "uShowTileHeat"), g_showClusterHeat ? 1 : 0);
+        glUniform1i(glGetUniformLocation(gProgram_DeferredLighting, "uDepth"), 0);
+        glUniform1i(glGetUniformLocation(gProgram_DeferredLighting, "uAlbedo"), 1);
+        glUniform1i(glGetUniformLocation(gProgram_DeferredLighting, "uNormal"), 2);
+        g_glState.bindTexture(0, GL_TEXTURE_2D, texDepthStencil);
+        g_glState.bindTexture(1, GL_TEXTURE_2D, texGAlbedo);
+        g_glState.bindTexture(2, GL_TEXTURE_2D, texGNormal);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, g_clustered.lightBuffer);
+        glBindImageTexture(0, texColorBuffer, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+        glDispatchCompute((rw + 15) / 16, (rh + 15) / 16, 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    // isWjSSAOGCѪR׺ AOAbilateral upsample ᪽i texColorBuffer (sŪ)
+    if (g_ssaoEnabled) {
+        GpuProfiler::Scope scope(g_gpuProfiler, "ssao");
+        ensureSSAOTexture(w, h); // ӳ̤jjptmAoVu aoW x aoH
+        const int aoW = (rw + g_ssaoScale - 1) / g_ssaoScale, aoH = (rh + g_ssaoScale - 1) / g_ssaoScale;
+        const glm::mat4 invP = glm::inverse(P);
+
+        g_glState.useProgram(gProgram_SSAO);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_SSAO, "uP"), 1, GL_FALSE, &P[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_SSAO, "uInvP"), 1, GL_FALSE, &invP[0][0]);
+        glUniform3fv(glGetUniformLocation(gProgram_SSAO, "uKernel"), SSAO_KERNEL_SIZE, &g_ssaoKernel[0][0]);
+        glUniform1i(glGetUniformLocation(gProgram_SSAO, "uKernelSize"), SSAO_KERNEL_SIZE);
+        glUniform1f(glGetUniformLocation(gProgram_SSAO, "uRadius"), g_ssaoRadius);
+        glUniform1i(glGetUniformLocation(gProgram_SSAO, "uScale"), g_ssaoScale);
+        glUniform2i(glGetUniformLocation(gProgram_SSAO, "uRenderSize"), rw, rh);
+        glUniform2i(glGetUniformLocation(gProgram_SSAO, "uAOSize"), aoW, aoH);
+        glUniform1i(glGetUniformLocation(gProgram_SSAO, "uDepth"), 0);
+        g_glState.bindTexture(0, GL_TEXTURE_2D, texDepthStencil);
+        glBindImageTexture(1, texSSAO, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG16F);
+        glDispatchCompute((aoW + 7) / 8, (aoH + 7) / 8, 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+        g_glState.useProgram(gProgram_SSAOUpsample);
+        glUniformMatrix4fv(glGetUniformLocation(gProgram_SSAOUpsample, "uInvP"), 1, GL_FALSE, &invP[0][0]);
+        glUniform1i(glGetUniformLocation(gProgram_SSAOUpsample, "uScale"), g_ssaoScale);
+        glUniform2i(glGetUniformLocation(gProgram_SSAOUpsample, "uRenderSize"), rw, rh);
+        glUniform2i(glGetUniformLocation(gProgram_SSAOUpsample, "uAOSize"), aoW, aoH);
+        glUniform1f(glGetUniformLocation(gProgram_SSAOUpsample, "uStrength"), g_ssaoStrength);
+        glUniform1i(glGetUniformLocation(gProgram_SSAOUpsample, "uShowAO"), g_ssaoShowAO ? 1 : 0);
+        glUniform1i(glGetUniformLocation(gProgram_SSAOUpsample, "uDepth"), 0);
+        glUniform1i(glGetUniformLocation(gProgram_SSAOUpsample, "uAO"), 1);
+        g_glState.bindTexture(1, GL_TEXTURE_2D, texSSAO);
+        glBindImageTexture(0, texColorBuffer, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
+        glDispatchCompute((rw + 7) / 8, (rh + 7) / 8, 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
 
     // ------------------------------------------------
     // --- Pass 2: Post-Process Pass (Vù) ---
@@ -459,68 +1885,136 @@ void on_display()
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    GLuint ppShader = gProgram_Passthrough; //Default
-    switch (g_postEffectMode) {
-        case 1: 
-            ppShader = gProgram_Abstraction;
-            break;
-        case 2: 
-            ppShader = gProgram_Watercolor; 
-            break;
-        case 3: 
-            ppShader = gProgram_Magnifier;
-            break;
-        case 4: 
-            ppShader = gProgram_Bloom; 
-            break;
-        case 5:
-            ppShader = gProgram_Pixelate;
-            break;
-        case 6:
-            ppShader = gProgram_SineWave;
-            break;
-        default:
-            ppShader = gProgram_Passthrough;
-            break;
-    }
-
-    if (!ppShader) return;
-    glUseProgram(ppShader);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texColorBuffer);
-    glUniform1i(glGetUniformLocation(ppShader, "uScreenTexture"), 0);
-    if (g_postEffectMode == 3) { // Magnifier
-        glUniform2f(glGetUniformLocation(ppShader, "uMousePos"),
-            g_MousePosNormalized.x,
-            1.0f - g_MousePosNormalized.y); // <-- ½ Y
-        glUniform1f(glGetUniformLocation(ppShader, "uRadius"), 0.2f);
-        glUniform1f(glGetUniformLocation(ppShader, "uZoom"), 2.0f);
-    }
-    else if (g_postEffectMode == 5) { // Pixelization
-        // iקjǰeTw
-        glUniform1f(glGetUniformLocation(ppShader, "uPixelSize"), 16.0f);
-    }
-    else if (g_postEffectMode == 6) { // Sine Wave
-        glUniform1f(glGetUniformLocation(ppShader, "uTime"), (float)glfwGetTime()); // oثeɶ
-        // iקjǰeTw ( PDF  power1, power2)
-        glUniform1f(glGetUniformLocation(ppShader, "uPower1"), 0.02f);
-        glUniform1f(glGetUniformLocation(ppShader, "uPower2"), 20.0f);
-    }
+    if (!gProgram_Passthrough) return;
+    const int postPass = g_gpuProfiler.begin("post");
+    // iקjs令iH걵 effect chainGC@qŪW@qGAGq render target pool ɡA
+    // ̫@qeùCW@q target ΧN١AҥH۾Fq|yΦPi (ping-pong)C
+    // iקjs REMAP / COLOR ĪGX֦@ pass
+    std::vector<PostPass> passes = buildPostPasses(g_postChain, g_postFusion);
+    if (passes.empty()) passes.push_back(PostPass{ { 0 }, 0, gProgram_Passthrough }); // ܤ֭n@qKù
+    g_postPassCount = (int)passes.size();
+
+    // ʺAѪRסGu texColorBuffer U rw x rhAĤ@qtdj + U
+    GLuint input = texColorBuffer;
+    float uvScaleX = (float)rw / (float)g_fboW, uvScaleY = (float)rh / (float)g_fboH;
+    float sharpness = g_dynamicResolution.sharpenAmount();
+    RenderTarget* previous = nullptr;
+    glBindVertexArray(quadVAO);
+    for (size_t i = 0; i < passes.size(); ++i) {
+        const PostPass& pass = passes[i];
+        const bool last = (i + 1 == passes.size());
+        const int effect = pass.effects.size() == 1 ? pass.effects[0] : -1; // FULL ĪG@wۤv@ pass
+        // isWjbloom n mip chain en (| fbo)AAeo@q
+        RenderTarget* bloom = effect == 4 ? renderBloomMipChain(input, uvScaleX, uvScaleY, w, h) : nullptr;
+        // isWjabstraction iH飼 computeFcompute ઽgùA̫@q]gi target A blit
+        GLuint computeShader = 0;
+        // iקjblur ˶ZWX compute  tile  apron  (j blur sizeBѪR) G|@ˡA飼 fragment 
+        const int blurPixels = (int)std::round(postParamValue("uAbstractionBlurSize") * std::max(w, h));
+        if (effect == 1 && g_postComputeBackend && blurPixels <= ABSTRACTION_CS_APRON) {
+            // X榡gi baseGsne]@wOP@ image 榡 (U glBindImageTexture @)
+            const std::string base = std::string("pp_cs_abstraction ") + POST_FORMATS[pass.format].imageFormat;
+            const std::string defines = std::string("#define OUTPUT_FORMAT ") + POST_FORMATS[pass.format].imageFormat + "\n" + postSpecializationDefines(1);
+            computeShader = g_shaderPermutations.get(base, postSpecializationDefines(1), gProgram_AbstractionCS[pass.format], [&] {
+                return startProgramBuild("", withDefines(loadShaderSource("shaders/pp_cs_abstraction.glsl"), defines));
+            });
+        }
+        const GLuint ppShader = computeShader ? computeShader : pass.program;
+        // iקjtemporal amortizationGo@qeiۤvv ( pool )C reproject S쪺 tileA
+        // ĪGu] reproject ƥXӪ tile MFv٤ (Ĥ@VBĪG / Ѽ / jp) ɲMNOiC
+        // ̫@q@˵eivA blit ù
+        TemporalHistory* history = (g_temporalPeriod > 1 && (effect == 1 || effect == 2) && gProgram_TemporalReprojectCS[pass.format])
+            ? &temporalHistoryFor(i, effect, ppShader, postParamValues(effect), POST_FORMATS[pass.format].format, w, h) : nullptr;
+        if (!history && i < g_temporalHistory.size())
+            g_temporalHistory[i].valid = false;
+        if (history)
+            temporalReproject(*history, pass.format, texDepthStencil, glm::vec2((float)rw / (float)g_fboW, (float)rh / (float)g_fboH),
+                P * V, cam.pos, w, h);
+
+        RenderTarget* output = (history || (last && !computeShader)) ? nullptr : g_renderTargetPool.acquire(w, h, POST_FORMATS[pass.format].format);
+        const GLuint outputFbo = history ? history->fbo[history->current ^ 1] : (output ? output->fbo : 0);
+        const GLuint outputTexture = history ? history->color[history->current ^ 1] : (output ? output->texture : 0);
+        if (!computeShader) {
+            glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+            glViewport(0, 0, w, h);
+        }
 
-    glUniform1i(glGetUniformLocation(ppShader, "uEnableComparison"), g_EnableComparisonBar ? 1 : 0); // Send bool as int
-    glUniform1f(glGetUniformLocation(ppShader, "uBarPosition"), g_BarPosition);
+        glUseProgram(ppShader);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, input);
+        glUniform1i(glGetUniformLocation(ppShader, "uScreenTexture"), 0);
+        glUniform2f(glGetUniformLocation(ppShader, "uUVScale"), uvScaleX, uvScaleY);
+        glUniform1f(glGetUniformLocation(ppShader, "uSharpness"), sharpness);
+        glUniform2f(glGetUniformLocation(ppShader, "uViewportSize"), (float)w, (float)h);
+        for (int e : pass.effects)
+            setupPostEffectUniforms(ppShader, e);
+        // P@ program  temporal H]n]^ 1 (pp_vs.glsl C post program o uniform)
+        glUniform1i(glGetUniformLocation(ppShader, "uTemporalPeriod"), history ? g_temporalPeriod : 1);
+        if (bloom) {
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, bloom->texture);
+            glActiveTexture(GL_TEXTURE0);
+            glUniform1i(glGetUniformLocation(ppShader, "uBloomTexture"), 2);
+            glUniform2f(glGetUniformLocation(ppShader, "uBloomUVScale"), bloom->uvScaleX(), bloom->uvScaleY());
+        }
+        // C@qb䳣OʤʪJA_ӥHᥪb䤴MOle
+        glUniform1i(glGetUniformLocation(ppShader, "uEnableComparison"), g_EnableComparisonBar ? 1 : 0); // Send bool as int
+        glUniform1f(glGetUniformLocation(ppShader, "uBarPosition"), g_BarPosition);
+        if (computeShader) {
+            glUniform2i(glGetUniformLocation(ppShader, "uOutputSize"), w, h);
+            glBindImageTexture(0, outputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, POST_FORMATS[pass.format].format);
+            if (history) { // temporalG@ work group @MW tile
+                glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, g_temporalIndirectBuffer);
+                glDispatchComputeIndirect(4 * sizeof(GLuint));
+            }
+            else {
+                glDispatchCompute((w + 15) / 16, (h + 15) / 16, 1);
+            }
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+        }
+        else {
+            // iקjĪGu]b|쪺d (comparison bar k / j誺)ALa誽ƻsJ
+            const PostRect active = postActiveRect(effect, w, h);
+            if (history) glBindVertexArray(g_temporalTileVAO);
+            drawPostRegions(active, w, h, uvScaleX, uvScaleY, sharpness, history != nullptr);
+            if (history) glBindVertexArray(quadVAO);
+        }
+        if (history) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+        }
+        if (last && outputFbo) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, outputFbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+        if (history) {
+            history->current ^= 1;
+            history->viewProj = P * V;
+            history->usedWidth = w;
+            history->usedHeight = h;
+            history->valid = true;
+        }
 
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        g_renderTargetPool.release(bloom);
+        g_renderTargetPool.release(previous);
+        previous = output; // vO pool ɪA
+        if (outputTexture) {
+            input = outputTexture;
+            uvScaleX = history ? (float)w / (float)history->width : output->uvScaleX();
+            uvScaleY = history ? (float)h / (float)history->height : output->uvScaleY();
+            sharpness = 0.0f;
+        }
+    }
+    for (size_t i = passes.size(); i < g_temporalHistory.size(); ++i)
+        g_temporalHistory[i].valid = false;
     glBindVertexArray(0);
+    g_renderTargetPool.release(previous); // ̫@qO compute ɷ|d
+    g_renderTargetPool.endFrame();
 
-    // Unbind noise texture (good practice)
-    if (g_postEffectMode == 2 && g_NoiseTexture != 0) { // Watercolor noise
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_NoiseTexture);
-        glUniform1i(glGetUniformLocation(ppShader, "uNoiseTexture"), 1);
-    }
+    // isWjtemporal amortizationGU@VU@ tile
+    g_temporalFrame++;
+    g_gpuProfiler.end(postPass);
 }
 
 void on_gui()
@@ -562,17 +2056,115 @@ void on_gui()
         ImGui::RadioButton("Textured", &g_sceneRenderMode, 0);
         ImGui::RadioButton("Normal Color", &g_sceneRenderMode, 1);
 
+        // isWj簣Ҧ
+        ImGui::Text("Culling");
+        ImGui::RadioButton("Off", &g_cullMode, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("BVH Frustum", &g_cullMode, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("Frustum + Occlusion Query", &g_cullMode, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Frustum + Software Occlusion", &g_cullMode, 3);
+        if (g_cullMode != 0)
+            ImGui::Text("in frustum: %zu / %zu", g_inFrustumCount, gSponza.meshes.size());
+        if (g_cullMode == 3)
+            ImGui::Text("after software occlusion: %zu (occluder triangles: %zu rasterized / %zu)", g_visibleMeshes.size(),
+                g_softwareOcclusion.numRasterizedTriangles(), g_softwareOcclusion.numOccluderTriangles());
+        if (g_cullMode == 1 || g_cullMode == 3) {
+            ImGui::Checkbox("Sort draws by state (program / VAO / depth)", &g_sortDrawsByState);
+            ImGui::Text("batches: %d, binds issued: %d, elided: %d",
+                g_renderQueue.batches(), g_glState.issued(), g_glState.elided());
+        }
+        if (g_cullMode == 2)
+            ImGui::Text("conditional: %d, unconditional: %d, occluded (last read back): %d",
+                g_occlusion.drawnConditional, g_occlusion.drawnUnconditional, g_occlusion.knownOccluded);
+
+        // isWjclustered forward  (u Textured Ҧ)
+        ImGui::Text("Local Lights");
+        ImGui::RadioButton("Forward (clustered)", &g_shadingPath, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Deferred (G-buffer + tiled)", &g_shadingPath, 1);
+        ImGui::Checkbox("Local lights", &g_clusteredLightsEnabled);
+        ImGui::SameLine();
+        ImGui::Checkbox("Show light count per cluster / tile", &g_showClusterHeat);
+        int lightCount = g_clustered.lightCount;
+        if (ImGui::SliderInt("Light count", &lightCount, 0, ClusteredLighting::MAX_LIGHTS))
+            g_clustered.generateLights(g_clustered.sceneMin, g_clustered.sceneMax, lightCount);
+
+        // isWjʺAѪR
+        ImGui::Text("Dynamic Resolution");
+        ImGui::Checkbox("Dynamic resolution", &g_dynamicResolution.enabled);
+        ImGui::SameLine();
+        ImGui::Text("scale %.2f", g_dynamicResolution.scale);
+        ImGui::SliderFloat("Target GPU ms", &g_dynamicResolution.targetMs, 4.0f, 33.0f);
+        ImGui::SliderFloat("Min scale", &g_dynamicResolution.minScale, 0.25f, 1.0f);
+        ImGui::SliderFloat("Upscale sharpness", &g_dynamicResolution.sharpness, 0.0f, 1.0f);
+
+        // isWjSSAO
+        ImGui::Text("Ambient Occlusion");
+        ImGui::Checkbox("SSAO", &g_ssaoEnabled);
+        ImGui::SameLine();
+        ImGui::RadioButton("Half res", &g_ssaoScale, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Quarter res", &g_ssaoScale, 4);
+        ImGui::SameLine();
+        ImGui::Checkbox("Show AO", &g_ssaoShowAO);
+        ImGui::SliderFloat("AO radius", &g_ssaoRadius, 0.05f, 2.0f);
+        ImGui::SliderFloat("AO strength", &g_ssaoStrength, 0.0f, 1.0f);
+
         ImGui::Separator(); // ju
 
         // @~nDUثsĪG
-        ImGui::Text("Post-Processing Effect");
-        ImGui::RadioButton("None", &g_postEffectMode, 0);
-        ImGui::RadioButton("Image Abstraction", &g_postEffectMode, 1);
-        ImGui::RadioButton("Watercolor", &g_postEffectMode, 2);
-        ImGui::RadioButton("Magnifier", &g_postEffectMode, 3);
-        ImGui::RadioButton("Bloom Effect", &g_postEffectMode, 4);
-        ImGui::RadioButton("Pixelization", &g_postEffectMode, 5);
-        ImGui::RadioButton("Sine Wave", &g_postEffectMode, 6);
+        // iקj令 effect chainGѤWU̧ǮMΡAG榡iHCqۤv
+        ImGui::Text("Post-Processing Chain");
+        int moveUp = -1, removeAt = -1;
+        for (int i = 0; i < (int)g_postChain.size(); ++i) {
+            ImGui::PushID(i);
+            ImGui::SetNextItemWidth(140.0f);
+            ImGui::Combo("##effect", &g_postChain[i].effect, POST_EFFECT_NAMES, IM_ARRAYSIZE(POST_EFFECT_NAMES));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(100.0f);
+            if (ImGui::BeginCombo("##format", POST_FORMATS[g_postChain[i].format].name)) {
+                for (int f = 0; f < IM_ARRAYSIZE(POST_FORMATS); ++f)
+                    if (ImGui::Selectable(POST_FORMATS[f].name, f == g_postChain[i].format))
+                        g_postChain[i].format = f;
+                ImGui::EndCombo();
+            }
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##up", ImGuiDir_Up) && i > 0) moveUp = i;
+            ImGui::SameLine();
+            if (ImGui::Button("X")) removeAt = i;
+            ImGui::PopID();
+        }
+        if (moveUp > 0) std::swap(g_postChain[moveUp], g_postChain[moveUp - 1]);
+        if (removeAt >= 0) g_postChain.erase(g_postChain.begin() + removeAt);
+        if (g_postChain.size() < MAX_POST_STAGES) {
+            static int addEffect = 1;
+            ImGui::SetNextItemWidth(140.0f);
+            ImGui::Combo("##add", &addEffect, POST_EFFECT_NAMES, IM_ARRAYSIZE(POST_EFFECT_NAMES));
+            ImGui::SameLine();
+            if (ImGui::Button("Add effect")) g_postChain.push_back(PostStage{ addEffect, 0 });
+        }
+        ImGui::Checkbox("Compute abstraction (shared-memory tiles)", &g_postComputeBackend);
+        ImGui::Checkbox("Fuse remap / color stages", &g_postFusion);
+        const char* temporalModes[] = { "Off", "Checkerboard tiles (1/2 per frame)", "2x2 rotating tiles (1/4 per frame)" };
+        int temporalMode = g_temporalPeriod == 4 ? 2 : (g_temporalPeriod == 2 ? 1 : 0);
+        if (ImGui::Combo("Temporal stylization", &temporalMode, temporalModes, IM_ARRAYSIZE(temporalModes)))
+            g_temporalPeriod = temporalMode == 2 ? 4 : (temporalMode == 1 ? 2 : 1);
+        ImGui::Text("Post passes: %d (%d shader permutations, %d compiling)", g_postPassCount,
+            (int)g_shaderPermutations.entries.size(), g_shaderPermutations.pending());
+        // isWjlink Ѫ shader (X֪|}eAW@qe passthrough)
+        for (const std::string& error : g_shaderPermutations.errors)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Link failed: %s", error.c_str());
+        // isWjĪGѼơGuCX chain ̦Ψ쪺ĪGF(compiled) |s shader
+        for (PostEffectParam& p : g_postParams) {
+            bool used = false;
+            for (const PostStage& s : g_postChain) used = used || s.effect == p.effect;
+            if (!used) continue;
+            const std::string label = std::string(p.label) + (p.specialize ? " (compiled)" : "");
+            ImGui::SliderFloat(label.c_str(), &p.value, p.minValue, p.maxValue, p.integer ? "%.0f" : "%.4f");
+        }
+        ImGui::Text("Render targets: %d pooled, %d allocated", (int)g_renderTargetPool.size(), g_renderTargetPool.allocations());
 
         // @~nDuComparison Barv
         ImGui::Separator();
@@ -592,6 +2184,20 @@ void on_gui()
         ImGui::SliderFloat("Pitch", &cam.pitch, -1.5f, 1.5f);
 
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+        g_gpuProfiler.drawImGui();
+
+        // isWjCPU trace (Chrome trace_event JSON)
+        bool traceEnabled = CpuTrace::enabled();
+        if (ImGui::Checkbox("CPU trace", &traceEnabled)) {
+            CpuTrace::setEnabled(traceEnabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Dump cpu_trace.json")) {
+            CpuTrace::dump("cpu_trace.json");
+        }
+
+        // isWjvGPNG ǦC Y4MAŪ^ 2~3 V~AvTq쪺 frame time
+        g_frameCapture.drawImGui();
         ImGui::End();
     }
 
@@ -611,15 +2217,112 @@ static void glfw_error_callback(int error, const char* description)
 	fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
-int main(int, char**)
+// isWjS GPU  (build agent) Ϊ headless ҦGs CpuPostEffects.h  CPU ]A
+// }] GL contextAiHӤ shader GΧ妸BzUӪ frameC
+//   HW2 --post-batch <ĪGs[,ĪGs...]> <XƧ> <frame.png> [frame.png ...]
+// ĪGs POST_EFFECT_NAMES @ (Ҧp 4,7 = Bloom A Tone Mapping)AѼƳOw]ȡC
+// S stb_image_writeAXg 32-bit TGA (header u 18 bytesAIbUn GL @)C
+static bool writeTGA(const std::string& path, const std::vector<unsigned char>& rgba, int w, int h) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    unsigned char header[18] = {};
+    header[2] = 2; // Y true color
+    header[12] = (unsigned char)(w & 0xFF); header[13] = (unsigned char)(w >> 8);
+    header[14] = (unsigned char)(h & 0xFF); header[15] = (unsigned char)(h >> 8);
+    header[16] = 32;
+    header[17] = 8; // 8 bit alphaAIU
+    fwrite(header, 1, sizeof(header), file);
+    std::vector<unsigned char> bgra(rgba.size());
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        bgra[i + 0] = rgba[i + 2];
+        bgra[i + 1] = rgba[i + 1];
+        bgra[i + 2] = rgba[i + 0];
+        bgra[i + 3] = rgba[i + 3];
+    }
+    const bool ok = fwrite(bgra.data(), 1, bgra.size(), file) == bgra.size();
+    fclose(file);
+    return ok;
+}
+
+static int runPostBatch(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " --post-batch <effect[,effect...]> <output dir> <frame.png> [frame.png ...]\n";
+        return 1;
+    }
+    std::vector<int> effects;
+    for (const char* s = argv[2]; *s; ) {
+        char* end = nullptr;
+        const long effect = strtol(s, &end, 10);
+        if (end == s || effect < 0 || effect >= CPU_POST_EFFECT_COUNT) {
+            std::cerr << "Invalid effect list: " << argv[2] << "\n";
+            return 1;
+        }
+        effects.push_back((int)effect);
+        s = (*end == ',') ? end + 1 : end;
+    }
+
+    //  loadTexture2D("assets/123.png", false) @ˤ½Fframe n½ row 0 bU
+    CpuImage noise;
+    int nw = 0, nh = 0, nc = 0;
+    stbi_set_flip_vertically_on_load(false);
+    if (stbi_uc* data = stbi_load("assets/123.png", &nw, &nh, &nc, 4)) {
+        noise = CpuImage::fromRGBA8(data, nw, nh);
+        stbi_image_free(data);
+    }
+
+    CpuPostEffects post;
+    const CpuPostParams params;
+    const std::string outDir = argv[3];
+    int failed = 0;
+    for (int i = 4; i < argc; ++i) {
+        const std::string path = argv[i];
+        int w = 0, h = 0, c = 0;
+        stbi_set_flip_vertically_on_load(true);
+        stbi_uc* data = stbi_load(path.c_str(), &w, &h, &c, 4);
+        if (!data) {
+            std::cerr << "Failed to load " << path << "\n";
+            failed++;
+            continue;
+        }
+        CpuImage image = CpuImage::fromRGBA8(data, w, h);
+        stbi_image_free(data);
+
+        const auto start = std::chrono::steady_clock::now();
+        CpuImage result;
+        for (int effect : effects) {
+            post.apply(effect, image, result, params, &noise);
+            std::swap(image, result);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<unsigned char> rgba((size_t)w * h * 4);
+        image.toRGBA8(rgba.data());
+        const size_t slash = path.find_last_of("/\\");
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        name = name.substr(0, name.find_last_of('.')) + ".tga";
+        if (!writeTGA(outDir + "/" + name, rgba, w, h)) {
+            std::cerr << "Failed to write " << outDir << "/" << name << "\n";
+            failed++;
+            continue;
+        }
+        printf("%s: %dx%d, %.2f ms (%d threads)\n", path.c_str(), w, h, ms, post.threadCount());
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
 {
+	if (argc > 1 && strcmp(argv[1], "--post-batch") == 0)
+		return runPostBatch(argc, argv);
+
 	glfwSetErrorCallback(glfw_error_callback);
 	if (!glfwInit())
 		return 1;
 
-	const char* glsl_version = "#version 410";
+	// iקjMultiDrawIndirect / SSBO ݭn 4.3 HWA令 HW3 @˥ 4.6
+	const char* glsl_version = "#version 460";
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
@@ -646,6 +2349,7 @@ int main(int, char**)
     gProgram_NormalColor = buildProgramFromFiles("shaders/scene_vs.glsl", "shaders/scene_fs_normal.glsl");
 
     //Pass2
+    g_shaderPermutations.init();
     gProgram_Passthrough = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_passthrough.glsl");
     gProgram_Pixelate = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_pixelate.glsl");
     gProgram_SineWave = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_sinewave.glsl");
@@ -653,6 +2357,21 @@ int main(int, char**)
     gProgram_Watercolor = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_watercolor.glsl");
     gProgram_Magnifier = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_magnifier.glsl");
     gProgram_Bloom = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_bloom.glsl");
+    gProgram_BloomPrefilter = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_bloom_prefilter.glsl");
+    gProgram_BloomDownsample = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_bloom_downsample.glsl");
+    gProgram_BloomUpsample = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_bloom_upsample.glsl");
+    gProgram_OcclusionBox = buildProgramFromFiles("shaders/occlusion_box_vs.glsl", "shaders/occlusion_box_fs.glsl");
+    gProgram_GBuffer = buildProgramFromFiles("shaders/scene_vs.glsl", "shaders/scene_fs_gbuffer.glsl");
+    gProgram_DeferredLighting = buildComputeProgramFromFile("shaders/deferred_lighting_cs.glsl");
+    gProgram_SSAO = buildComputeProgramFromFile("shaders/ssao_cs.glsl");
+    gProgram_SSAOUpsample = buildComputeProgramFromFile("shaders/ssao_upsample_cs.glsl");
+    for (int f = 0; f < NUM_POST_FORMATS; ++f) {
+        gProgram_AbstractionCS[f] = buildComputeProgramFromFile("shaders/pp_cs_abstraction.glsl",
+            std::string("#define OUTPUT_FORMAT ") + POST_FORMATS[f].imageFormat + "\n");
+        gProgram_TemporalReprojectCS[f] = buildComputeProgramFromFile("shaders/pp_cs_temporal_reproject.glsl",
+            std::string("#define OUTPUT_FORMAT ") + POST_FORMATS[f].imageFormat + "\n");
+    }
+    initSSAOKernel();
 
     //comparison bar
     gProgram_Comparison = buildProgramFromFiles("shaders/pp_vs.glsl", "shaders/pp_fs_comparison.glsl");
@@ -691,6 +2410,20 @@ int main(int, char**)
         fprintf(stderr, "[InitCam] pos(%.3f,%.3f,%.3f) yaw=%.3f pitch=%.3f\n",
             cam.pos.x, cam.pos.y, cam.pos.z, cam.yaw, cam.pitch);
     }
+    gSponza.buildBVH(gModel); // gModel Mw~ world AABB
+    gSponza.buildOccluders(gModel, g_softwareOcclusion);
+
+    // isWjbӳ world AABB 
+    {
+        glm::vec3 worldMin(std::numeric_limits<float>::infinity()), worldMax(-std::numeric_limits<float>::infinity());
+        for (const BvhAabb& b : gSponza.bvh.boxes()) {
+            worldMin = glm::min(worldMin, b.min);
+            worldMax = glm::max(worldMax, b.max);
+        }
+        g_clustered.init();
+        if (!gSponza.meshes.empty())
+            g_clustered.generateLights(worldMin, worldMax, g_clustered.lightCount);
+    }
 
     float quadVertices[] = {
         // positions   // texCoords
@@ -710,6 +2443,27 @@ int main(int, char**)
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glBindVertexArray(0); // Ѱjw
 
+    // isWjtemporalGP@ quad A[@ӨC instance @檺 tile M (pp_vs.glsl  aTemporalTile)
+    glGenBuffers(1, &g_temporalTileBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, g_temporalTileBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW); // Ĥ@ΪɭԦAj
+    glGenBuffers(1, &g_temporalIndirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_temporalIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, 8 * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glGenVertexArrays(1, &g_temporalTileVAO);
+    glBindVertexArray(g_temporalTileVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, g_temporalTileBuffer);
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+
     // 򥻬۾x}
     int fbw, fbh;
     glfwGetFramebufferSize(window, &fbw, &fbh);
@@ -720,7 +2474,7 @@ int main(int, char**)
     //gModel = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
     // ====== i즹j ======================================================
     
-    createFramebuffer(fbw, fbh);
+    ensureFramebuffer(fbw, fbh);
 
 	// Setup Dear ImGui context
 	IMGUI_CHECKVERSION();
@@ -747,6 +2501,8 @@ int main(int, char**)
 	while (!glfwWindowShouldClose(window))
 
 	{
+		TRACE_SCOPE("frame");
+
 		// Poll and handle events (inputs, window resize, etc.)
 		// You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
 		// - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
@@ -765,16 +2521,36 @@ int main(int, char**)
 		ImGui::NewFrame();
 		on_gui();
 		// Rendering
+		g_gpuProfiler.beginFrame();
 		on_display();
 		ImGui::Render();
 		int display_w, display_h;
 		glfwGetFramebufferSize(window, &display_w, &display_h);
 		glViewport(0, 0, display_w, display_h);
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		{
+			GpuProfiler::Scope scope(g_gpuProfiler, "imgui");
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		}
+		g_frameCapture.captureFrame(display_w, display_h);
 		glfwSwapBuffers(window);
 	}
 
 	// Cleanup
+	g_gpuProfiler.release();
+	g_frameCapture.release();
+	g_shaderPermutations.release();
+	for (TemporalHistory& t : g_temporalHistory) {
+		glDeleteFramebuffers(2, t.fbo);
+		glDeleteTextures(2, t.color);
+		glDeleteTextures(2, t.depth);
+	}
+	glDeleteVertexArrays(1, &g_temporalTileVAO);
+	glDeleteBuffers(1, &g_temporalTileBuffer);
+	glDeleteBuffers(1, &g_temporalIndirectBuffer);
+	g_renderTargetPool.releaseAll();
+	if (CpuTrace::enabled()) {
+		CpuTrace::dump("cpu_trace.json");
+	}
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
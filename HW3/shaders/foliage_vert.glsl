@@ -1,9 +1,5 @@
 #version 460 core
 
-layout(location = 0) in vec3 a_Pos;
-layout(location = 1) in vec3 a_Normal;
-layout(location = 2) in vec2 a_UV;
-
 struct PlantData {
     vec4 positionAndType; 
 };
@@ -12,6 +8,27 @@ layout(std430, binding = 0) buffer PlantBuffer {
     PlantData plants[];
 };
 
+// 壓縮頂點 (對應 C++ 的 PackedVertex，16 bytes)
+struct PackedVertex {
+    uint posXY;     // half2
+    uint posZ;      // half2 (z, 0)
+    uint normalOct; // snorm16x2 octahedral
+    uint uv;        // half2
+};
+
+layout(std430, binding = 5) readonly buffer GeometryPoolVertexBuffer {
+    PackedVertex vertices[];
+};
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 signNotZero = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signNotZero;
+    }
+    return normalize(n);
+}
+
 uniform mat4 u_View;
 uniform mat4 u_Proj;
 
@@ -23,6 +40,12 @@ out vec3 f_viewVertex;
 void main() {
     uint idx = gl_BaseInstance + gl_InstanceID;
     vec4 data = plants[idx].positionAndType;
+
+    // vertex pulling：gl_VertexID 已經包含 draw command 的 baseVertex
+    PackedVertex pv = vertices[gl_VertexID];
+    vec3 a_Pos = vec3(unpackHalf2x16(pv.posXY), unpackHalf2x16(pv.posZ).x);
+    vec3 a_Normal = octDecode(unpackSnorm2x16(pv.normalOct));
+    vec2 a_UV = unpackHalf2x16(pv.uv);
     
     vec3 worldPos = data.xyz + a_Pos;
     
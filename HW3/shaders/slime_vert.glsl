@@ -1,7 +1,25 @@
 #version 460 core
-layout(location = 0) in vec3 a_Pos;
-layout(location = 1) in vec3 a_Normal;
-layout(location = 2) in vec2 a_UV;
+
+// 壓縮頂點 (對應 C++ 的 PackedVertex，16 bytes)，跟植物共用同一個 GeometryPool
+struct PackedVertex {
+    uint posXY;     // half2
+    uint posZ;      // half2 (z, 0)
+    uint normalOct; // snorm16x2 octahedral
+    uint uv;        // half2
+};
+
+layout(std430, binding = 5) readonly buffer GeometryPoolVertexBuffer {
+    PackedVertex vertices[];
+};
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 signNotZero = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signNotZero;
+    }
+    return normalize(n);
+}
 
 uniform mat4 u_Proj;
 uniform mat4 u_View;
@@ -12,6 +30,12 @@ out vec3 v_Normal;
 out vec3 v_WorldPos;
 
 void main() {
+    // vertex pulling：gl_VertexID 已經包含 draw command 的 baseVertex
+    PackedVertex pv = vertices[gl_VertexID];
+    vec3 a_Pos = vec3(unpackHalf2x16(pv.posXY), unpackHalf2x16(pv.posZ).x);
+    vec3 a_Normal = octDecode(unpackSnorm2x16(pv.normalOct));
+    vec2 a_UV = unpackHalf2x16(pv.uv);
+
     // 世界座標
     vec4 worldPos = u_Model * vec4(a_Pos, 1.0);
     v_WorldPos = worldPos.xyz;
@@ -1,5 +1,7 @@
 #include "RenderingOrderExp.h"
 #include "../Common.h"
+#include <glm/gtc/packing.hpp>
+#include "../CpuTrace.h"
 
 // 引入影像讀取庫
 //#define STB_IMAGE_IMPLEMENTATION
@@ -10,6 +12,27 @@
 
 namespace INANOA {	
 
+	// 八面體 (octahedral) 法線編碼：單位向量 -> [-1,1]^2
+	static glm::vec2 OctEncode(glm::vec3 n) {
+		n = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+		glm::vec2 e(n.x, n.y);
+		if (n.z < 0.0f) {
+			const glm::vec2 signNotZero(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+			e = (glm::vec2(1.0f) - glm::abs(glm::vec2(e.y, e.x))) * signNotZero;
+		}
+		return e;
+	}
+
+	// 轉成 foliage_vert.glsl / slime_vert.glsl 讀取的 16-byte 壓縮格式
+	static PackedVertex packVertex(const glm::vec3& p, const glm::vec3& n, const glm::vec2& t) {
+		PackedVertex v;
+		v.posXY = glm::packHalf2x16(glm::vec2(p.x, p.y));
+		v.posZ = glm::packHalf2x16(glm::vec2(p.z, 0.0f));
+		v.normalOct = glm::packSnorm2x16(OctEncode(n));
+		v.uv = glm::packHalf2x16(t);
+		return v;
+	}
+
 	static GLuint CreateStorageBuffer(GLsizeiptr size, const void* data, GLenum usage) {
 		GLuint bufferID = 0;
 		glGenBuffers(1, &bufferID);
@@ -26,9 +49,13 @@ namespace INANOA {
 		this->m_frameWidth = 64;
 		this->m_frameHeight = 64;
 	}
-	RenderingOrderExp::~RenderingOrderExp(){}
+	RenderingOrderExp::~RenderingOrderExp(){
+		this->m_gpuProfiler.release();
+		delete this->m_geometryPool;
+	}
 
 	bool RenderingOrderExp::init(const int w, const int h) {
+		TRACE_SCOPE("RenderingOrderExp::init");
 		INANOA::OPENGL::RendererBase* renderer = new INANOA::OPENGL::RendererBase();
 		const std::string vsFile = "shaders\\vertexShader_ogl_450.glsl";
 		const std::string fsFile = "shaders\\fragmentShader_ogl_450.glsl";
@@ -124,6 +151,7 @@ namespace INANOA {
 
 	// [請替換掉原本的 update 函式]
 	void RenderingOrderExp::update() {
+		TRACE_SCOPE("RenderingOrderExp::update");
 		// =====================================================
 		// 1. God View Camera 更新 (使用 Trackball)
 		// =====================================================
@@ -192,6 +220,9 @@ namespace INANOA {
 
 	void RenderingOrderExp::render()
 	{
+		TRACE_SCOPE("RenderingOrderExp::render");
+		m_gpuProfiler.beginFrame();
+
 		this->m_renderer->clearRenderTarget();
 		const int HW = this->m_frameWidth * 0.5;
 
@@ -210,19 +241,31 @@ namespace INANOA {
 
 		// 地板
 		glEnable(GL_DEPTH_TEST);
-		this->m_renderer->setShadingModel(OPENGL::ShadingModelType::PROCEDURAL_GRID);
-		this->m_horizontalGround->render();
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "god/ground");
+			this->m_renderer->setShadingModel(OPENGL::ShadingModelType::PROCEDURAL_GRID);
+			this->m_horizontalGround->render();
+		}
 
 		// 草
-		renderFoliage(m_godCamera);
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "god/foliage");
+			renderFoliage(m_godCamera);
+		}
 
 		// slime
-		renderSlime(m_godCamera, m_slimePos);
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "god/slime");
+			renderSlime(m_godCamera, m_slimePos);
+		}
 
 		// 框線 overlay（最後畫）
 		glDisable(GL_DEPTH_TEST);
-		this->m_renderer->setShadingModel(OPENGL::ShadingModelType::UNLIT);
-		this->m_viewFrustum->render();
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "god/overlay");
+			this->m_renderer->setShadingModel(OPENGL::ShadingModelType::UNLIT);
+			this->m_viewFrustum->render();
+		}
 		glEnable(GL_DEPTH_TEST);
 
 		// ============================================================
@@ -238,19 +281,31 @@ namespace INANOA {
 
 		// 地板
 		glEnable(GL_DEPTH_TEST);
-		this->m_renderer->setShadingModel(OPENGL::ShadingModelType::PROCEDURAL_GRID);
-		this->m_horizontalGround->render();
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "player/ground");
+			this->m_renderer->setShadingModel(OPENGL::ShadingModelType::PROCEDURAL_GRID);
+			this->m_horizontalGround->render();
+		}
 
 		// 草
-		renderFoliage(m_playerCamera);
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "player/foliage");
+			renderFoliage(m_playerCamera);
+		}
 
 		// slime
-		renderSlime(m_playerCamera, m_slimePos);
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "player/slime");
+			renderSlime(m_playerCamera, m_slimePos);
+		}
 
 		// 框線 overlay
 		glDisable(GL_DEPTH_TEST);
-		this->m_renderer->setShadingModel(OPENGL::ShadingModelType::UNLIT);
-		this->m_viewFrustum->render();
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "player/overlay");
+			this->m_renderer->setShadingModel(OPENGL::ShadingModelType::UNLIT);
+			this->m_viewFrustum->render();
+		}
 		glEnable(GL_DEPTH_TEST);
 	}
 
@@ -291,6 +346,7 @@ namespace INANOA {
 	// =========================================================
 
 	bool RenderingOrderExp::initResources() {
+		TRACE_SCOPE("RenderingOrderExp::initResources");
 		// --------------------------------------------------------
 		// [新增] 檢查目前使用的 GPU
 		const GLubyte* renderer = glGetString(GL_RENDERER);
@@ -298,6 +354,14 @@ namespace INANOA {
 		printf("Renderer: %s\n", renderer);
 		printf("OpenGL Version: %s\n", version);
 		// --------------------------------------------------------
+
+		// [修改] 所有 mesh 共用一個 pool，不再逐一建 VAO 之後讀回來合併
+		// 初始容量夠放作業的植物 + 史萊姆，不夠時 pool 會在 GPU 上自己擴充
+		m_geometryPool = new OPENGL::GeometryPool(sizeof(PackedVertex), 1u << 16, 1u << 18);
+		if (!m_geometryPool->init()) {
+			printf("Failed to create geometry pool\n");
+			return false;
+		}
 		
 		// 1. 載入模型 (OBJ)
 		// 請確認 assets 路徑是否正確，這對應到作業提供的檔案
@@ -305,12 +369,6 @@ namespace INANOA {
 		if (!loadOBJ("assets/models/foliages/bush01_lod2.obj", m_meshes[1])) return false;
 		if (!loadOBJ("assets/models/foliages/bush05_lod2.obj", m_meshes[2])) return false;
 
-		// [新增] 把三個 mesh 整合成一個大 VAO，給 MultiDraw 用
-		if (!buildFoliageMultiDrawVAO()) {
-			printf("Failed to build merged foliage VAO\n");
-			return false;
-		}
-
 		// 2. 建立 Texture Array (將三張貼圖合併) [cite: 61-64]
 		std::vector<std::string> texFiles = {
 			"assets/textures/grassB_albedo.png", // Layer 0
@@ -329,6 +387,7 @@ namespace INANOA {
 	// 簡單的 OBJ 載入器 (只讀取 v, vt, vn, f)
 	// 使用 Common.h 的 loadObj 來載入模型
 	bool RenderingOrderExp::loadOBJ(const std::string& path, SimpleMesh& outMesh) {
+		TRACE_SCOPE("RenderingOrderExp::loadOBJ");
 		// 1. 呼叫 Common.h 的全域函式載入模型
 		// 注意：loadObj 回傳的是 std::vector<MeshData>
 		std::vector<MeshData> meshes = loadObj(path.c_str());
@@ -341,7 +400,7 @@ namespace INANOA {
 		// 我們只取第一個 Mesh (通常作業的模型只有一個 shape)
 		const MeshData& data = meshes[0];
 
-		// 定義頂點結構 (用來整理資料給 OpenGL)
+		// 定義頂點結構 (用來整理資料，最後壓成 PackedVertex)
 		struct Vertex {
 			glm::vec3 p;
 			glm::vec3 n;
@@ -349,6 +408,7 @@ namespace INANOA {
 		};
 		std::vector<Vertex> finalVertices;
 		std::vector<unsigned int> finalIndices;
+		std::vector<PackedVertex> packedVertices;
 
 		// Common.h 的 loadObj 已經處理好 index 了
 		// data.positions 是平坦的 float array (x,y,z, x,y,z...)
@@ -393,46 +453,44 @@ namespace INANOA {
 			finalIndices.push_back(idx);
 		}
 
-		// 3. 建立 OpenGL Buffers
-		if (outMesh.vao != 0) glDeleteVertexArrays(1, &outMesh.vao);
-		if (outMesh.vbo != 0) glDeleteBuffers(1, &outMesh.vbo);
-		if (outMesh.ebo != 0) glDeleteBuffers(1, &outMesh.ebo);
-
-		glGenVertexArrays(1, &outMesh.vao);
-		glGenBuffers(1, &outMesh.vbo);
-		glGenBuffers(1, &outMesh.ebo);
-
-		glBindVertexArray(outMesh.vao);
-
-		glBindBuffer(GL_ARRAY_BUFFER, outMesh.vbo);
-		glBufferData(GL_ARRAY_BUFFER, finalVertices.size() * sizeof(Vertex), finalVertices.data(), GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, outMesh.ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, finalIndices.size() * sizeof(unsigned int), finalIndices.data(), GL_STATIC_DRAW);
-
-		// 設定 Vertex Attributes (對應 Shader 的 layout location)
-		// Location 0: Pos
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, p));
-
-		// Location 1: Normal
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, n));
+		// 計算包圍球：中心取 AABB 中心，半徑取離中心最遠的頂點 (比 AABB 半對角線更緊)
+		glm::vec3 aabbMin(std::numeric_limits<float>::max());
+		glm::vec3 aabbMax(-std::numeric_limits<float>::max());
+		for (const Vertex& v : finalVertices) {
+			aabbMin = glm::min(aabbMin, v.p);
+			aabbMax = glm::max(aabbMax, v.p);
+		}
+		const glm::vec3 sphereCenter = 0.5f * (aabbMin + aabbMax);
+		float sphereRadius = 0.0f;
+		for (const Vertex& v : finalVertices) {
+			sphereRadius = std::max(sphereRadius, glm::distance(v.p, sphereCenter));
+		}
+		outMesh.boundingSphere = glm::vec4(sphereCenter, sphereRadius);
 
-		// Location 2: UV
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, t));
+		// 3. 壓縮後直接寫進 GeometryPool (index 保持 mesh 內的相對值，由 draw command 的 baseVertex 加上偏移)
+		packedVertices.reserve(finalVertices.size());
+		for (const Vertex& v : finalVertices) {
+			packedVertices.push_back(packVertex(v.p, v.n, v.t));
+		}
 
-		glBindVertexArray(0);
+		releaseMesh(outMesh); // 重複載入時先把舊的空間還回去
+		outMesh.geometry = m_geometryPool->allocate(packedVertices.data(), (GLuint)packedVertices.size(),
+			finalIndices.data(), (GLuint)finalIndices.size());
+		if (!outMesh.geometry.valid()) {
+			printf("GeometryPool allocation failed: %s\n", path.c_str());
+			return false;
+		}
 
 		outMesh.indexCount = (unsigned int)finalIndices.size();
 
-		printf("Loaded Mesh (via Common.h): %s, Verts: %zu, Indices: %d\n", path.c_str(), numVertices, outMesh.indexCount);
+		printf("Loaded Mesh (via Common.h): %s, Verts: %zu, Indices: %d, Bounding sphere r=%.3f, pool firstIndex=%u baseVertex=%u\n",
+			path.c_str(), numVertices, outMesh.indexCount, sphereRadius, outMesh.geometry.firstIndex, outMesh.geometry.baseVertex);
 
 		return true;
 	}
 
 	GLuint RenderingOrderExp::createTextureArray(const std::vector<std::string>& files) {
+		TRACE_SCOPE("RenderingOrderExp::createTextureArray");
 		if (files.empty()) return 0;
 
 		int w, h, ch;
@@ -472,6 +530,7 @@ namespace INANOA {
 	}
 
 	void RenderingOrderExp::loadSpatialSamples() {
+		TRACE_SCOPE("RenderingOrderExp::loadSpatialSamples");
 		using namespace INANOA::SCENE::EXPERIMENTAL;
 
 		// 請確認檔名與作業一致 [cite: 131]
@@ -529,6 +588,7 @@ namespace INANOA {
 	}
 
 	void RenderingOrderExp::createFoliageBuffers() {
+		TRACE_SCOPE("RenderingOrderExp::createFoliageBuffers");
 		// 1. 建立 Source SSBO (存放所有植物資料)
 		// ---------------------------------------------------------
 		glGenBuffers(1, &m_ssbo_AllPlants);
@@ -571,8 +631,8 @@ namespace INANOA {
 		auto FillCmd = [&](int id) {
 			cmds[id].count = m_meshes[id].indexCount;
 			cmds[id].instanceCount = m_plantCounts[id];
-			cmds[id].firstIndex = m_firstIndex[id];
-			cmds[id].baseVertex = m_baseVertex[id];
+			cmds[id].firstIndex = m_meshes[id].geometry.firstIndex;
+			cmds[id].baseVertex = m_meshes[id].geometry.baseVertex;
 			cmds[id].baseInstance = m_plantOffsets[id];
 			};
 
@@ -668,9 +728,10 @@ namespace INANOA {
 
 		// --- SSBO & indirect draw ---
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ssbo_Visible);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, POOL_VERTEX_BINDING, m_geometryPool->vertexBufferHandle());
 		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_ssbo_Indirect);
 
-		glBindVertexArray(m_foliageVAO);
+		glBindVertexArray(m_geometryPool->vaoHandle());
 		glMultiDrawElementsIndirect(
 			GL_TRIANGLES,
 			GL_UNSIGNED_INT,
@@ -686,6 +747,7 @@ namespace INANOA {
 
 	// 初始化 Compute Shaders
 	bool RenderingOrderExp::initCullingShaders() {
+		TRACE_SCOPE("RenderingOrderExp::initCullingShaders");
 		// 建立一個專門載入 Compute Shader 的 helper lambda
 		auto createCompute = [](const char* path) -> GLuint {
 			FILE* f = fopen(path, "rb");
@@ -786,10 +848,20 @@ namespace INANOA {
 		glUseProgram(m_programCull);
 
 		// --- Uniforms (確保名稱與 Shader 一致) ---
-		glm::mat4 vp = cam->projMatrix() * cam->viewMatrix();
-		glUniformMatrix4fv(glGetUniformLocation(m_programCull, "u_viewProj"), 1, GL_FALSE, &vp[0][0]);
+		// 世界座標的 6 個視錐平面，取代原本在 clip space 放寬 1.2 倍的測試
+		glm::vec4 frustumPlanes[6];
+		cam->viewFrustumPlanesInWorldSpace(frustumPlanes);
+		glUniform4fv(glGetUniformLocation(m_programCull, "u_frustumPlanes"), 6, &frustumPlanes[0][0]);
 		glUniform1ui(glGetUniformLocation(m_programCull, "u_totalInstance"), (GLuint)m_allInstancesCPU.size());
 
+		// 每種植物各自的包圍球 (instance 只有平移，所以半徑不變)
+		glm::vec4 typeSpheres[3] = {
+			m_meshes[0].boundingSphere,
+			m_meshes[1].boundingSphere,
+			m_meshes[2].boundingSphere
+		};
+		glUniform4fv(glGetUniformLocation(m_programCull, "u_typeBoundingSphere"), 3, &typeSpheres[0][0]);
+
 		// 這些是參考答案需要的額外參數，請補上：
 		glUniform1ui(glGetUniformLocation(m_programCull, "u_startA"), m_plantOffsets[0]);
 		glUniform1ui(glGetUniformLocation(m_programCull, "u_startB"), m_plantOffsets[1]);
@@ -815,10 +887,13 @@ namespace INANOA {
 		// Binding 4: 參考答案還有一個 InstanceOffset Buffer，如果你沒有額外的 VBO，可以先不綁，或者把 m_ssbo_Visible 綁上去試試 (因為結構相似)
 
 		// Dispatch
-		glDispatchCompute((GLuint)(m_allInstancesCPU.size() + 255) / 256, 1, 1);
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "cull");
+			glDispatchCompute((GLuint)(m_allInstancesCPU.size() + 255) / 256, 1, 1);
 
-		//glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
-		glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+			//glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+			glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+		}
 
 		// 3. 執行 UpdateCmd Shader
 		glUseProgram(m_programUpdateCmd);
@@ -830,9 +905,12 @@ namespace INANOA {
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_ssbo_Indirect);   // Binding 2: Cmds
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_ssbo_Counter);    // Binding 3: Counts
 
-		glDispatchCompute(3, 1, 1); // 參考答案 local_size_x = 3，所以 Dispatch 1 就夠了
+		{
+			GpuProfiler::Scope scope(m_gpuProfiler, "update_cmd");
+			glDispatchCompute(3, 1, 1); // 參考答案 local_size_x = 3，所以 Dispatch 1 就夠了
 
-		glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+			glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+		}
 		glUseProgram(prevProgram);
 		// ====== 在這裡印出目前 GPU 上的 instanceCount ======
 		//debugIndirectCmd(m_ssbo_Indirect);
@@ -892,12 +970,25 @@ namespace INANOA {
 	}
 
 	bool RenderingOrderExp::initSlimeResources() {
+		TRACE_SCOPE("RenderingOrderExp::initSlimeResources");
 		// 1. 載入 Mesh (使用你的 loadOBJ 函式)
 		if (!loadOBJ("assets/models/foliages/slime.obj", m_meshSlime)) {
 			printf("Failed to load slime.obj\n");
 			return false;
 		}
 
+		// [新增] 史萊姆也從 pool 畫，用一個 command 的 MDI
+		IndirectDrawCmd cmd;
+		cmd.count = m_meshSlime.indexCount;
+		cmd.instanceCount = 1;
+		cmd.firstIndex = m_meshSlime.geometry.firstIndex;
+		cmd.baseVertex = m_meshSlime.geometry.baseVertex;
+		cmd.baseInstance = 0;
+		glGenBuffers(1, &m_slimeIndirect);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_slimeIndirect);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(IndirectDrawCmd), &cmd, GL_STATIC_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
 		// 2. 載入 Texture (使用你的 loadTexture2D 函式)
 		m_texSlime = loadTexture2D("assets/textures/slime_albedo.jpg");
 		if (m_texSlime == 0) {
@@ -948,132 +1039,21 @@ namespace INANOA {
 		glBindTexture(GL_TEXTURE_2D, m_texSlime);
 		glUniform1i(glGetUniformLocation(m_programSlime, "u_Tex"), 0);
 
-		// 繪製
-		glBindVertexArray(m_meshSlime.vao);
-		glDrawElements(GL_TRIANGLES, m_meshSlime.indexCount, GL_UNSIGNED_INT, 0);
+		// 繪製 (vertex pulling + 單一 command 的 MDI)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, POOL_VERTEX_BINDING, m_geometryPool->vertexBufferHandle());
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_slimeIndirect);
+		glBindVertexArray(m_geometryPool->vaoHandle());
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, 1, sizeof(IndirectDrawCmd));
 		glBindVertexArray(0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 		glUseProgram(prevProgram);
 	}
 
-	// -----------------------------------------------------------------------------
-// 把 m_meshes[0..2] 的 VBO/EBO 整合成一個大 VAO
-// 注意：只是初始化時做一次，多讀一點 GPU 資料沒關係。
-// -----------------------------------------------------------------------------
-	bool RenderingOrderExp::buildFoliageMultiDrawVAO()
-	{
-		// 要跟 loadOBJ 裡的 layout 一樣
-		struct VertexLayout {
-			glm::vec3 p;
-			glm::vec3 n;
-			glm::vec2 t;
-		};
-
-		// 先問每個 mesh 的 VBO / EBO 大小，計算總長度
-		GLint vboSize[3] = { 0,0,0 };
-		GLint eboSize[3] = { 0,0,0 };
-		size_t totalVboBytes = 0;
-		size_t totalIndexCount = 0;
-
-		for (int i = 0; i < 3; ++i) {
-			glBindVertexArray(m_meshes[i].vao);
-
-			glBindBuffer(GL_ARRAY_BUFFER, m_meshes[i].vbo);
-			glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &vboSize[i]);
-
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_meshes[i].ebo);
-			glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &eboSize[i]);
-
-			totalVboBytes += (size_t)vboSize[i];
-			totalIndexCount += (size_t)eboSize[i] / sizeof(GLuint);
-		}
-
-		if (totalVboBytes == 0 || totalIndexCount == 0)
-			return false;
-
-		// 準備合併後的大 buffer
-		std::vector<unsigned char> allVerts(totalVboBytes);
-		std::vector<GLuint>        allIndices(totalIndexCount);
-
-		// 目前大 buffer 中的 offset（以「頂點數」為單位）
-		size_t currentVertexOffset = 0;
-		size_t currentIndexOffset = 0;
-
-		for (int i = 0; i < 3; ++i) {
-			// ------------- 把第 i 個 mesh 的 VBO 讀出來 -------------
-			glBindBuffer(GL_ARRAY_BUFFER, m_meshes[i].vbo);
-
-			std::vector<unsigned char> tmpVerts(vboSize[i]);
-			glGetBufferSubData(GL_ARRAY_BUFFER, 0, vboSize[i], tmpVerts.data());
-
-			// bytes -> 放到大 VBO 中合適的位置
-			size_t dstByteOffset = currentVertexOffset * sizeof(VertexLayout);
-			std::memcpy(allVerts.data() + dstByteOffset, tmpVerts.data(), vboSize[i]);
-
-			// 第 i 種的 baseVertex（以「頂點 index」計）
-			m_baseVertex[i] = (GLuint)currentVertexOffset;
-
-			// ------------- 把第 i 個 mesh 的 EBO 讀出來 -------------
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_meshes[i].ebo);
-
-			size_t idxCount = (size_t)eboSize[i] / sizeof(GLuint);
-			std::vector<GLuint> tmpIdx(idxCount);
-			glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, eboSize[i], tmpIdx.data());
-
-			// 將 index 加上 vertex offset 後丟到大 index buffer
-			m_firstIndex[i] = (GLuint)currentIndexOffset;  // 這一段的 index 起點
-
-			for (size_t k = 0; k < idxCount; ++k) {
-				allIndices[currentIndexOffset + k] = tmpIdx[k] + (GLuint)currentVertexOffset;
-			}
-
-			// 累加 offset
-			currentVertexOffset += (size_t)vboSize[i] / sizeof(VertexLayout);
-			currentIndexOffset += idxCount;
+	// 把 mesh 佔用的 pool 空間還回去，之後載入的 mesh 可以重複使用
+	void RenderingOrderExp::releaseMesh(SimpleMesh& mesh) {
+		if (m_geometryPool != nullptr) {
+			m_geometryPool->release(mesh.geometry);
 		}
-
-		// 建立合併後的 VAO / VBO / EBO
-		if (m_foliageVAO) {
-			glDeleteVertexArrays(1, &m_foliageVAO);
-			glDeleteBuffers(1, &m_foliageVBO);
-			glDeleteBuffers(1, &m_foliageEBO);
-		}
-
-		glGenVertexArrays(1, &m_foliageVAO);
-		glGenBuffers(1, &m_foliageVBO);
-		glGenBuffers(1, &m_foliageEBO);
-
-		glBindVertexArray(m_foliageVAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_foliageVBO);
-		glBufferData(GL_ARRAY_BUFFER, totalVboBytes, allVerts.data(), GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_foliageEBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-			totalIndexCount * sizeof(GLuint),
-			allIndices.data(),
-			GL_STATIC_DRAW);
-
-		// 設定 attribute layout，跟 loadOBJ 裡的一樣
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-			sizeof(VertexLayout),
-			(void*)offsetof(VertexLayout, p));
-
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-			sizeof(VertexLayout),
-			(void*)offsetof(VertexLayout, n));
-
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-			sizeof(VertexLayout),
-			(void*)offsetof(VertexLayout, t));
-
-		glBindVertexArray(0);
-
-		printf("Merged foliage VAO built. total verts bytes=%zu, total indices=%zu\n",
-			totalVboBytes, totalIndexCount);
-
-		return true;
+		mesh.indexCount = 0;
 	}
 }
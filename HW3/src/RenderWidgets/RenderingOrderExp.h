@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "../Rendering/RendererBase.h"
+#include "../Rendering/GeometryPool.h"
 #include "../Scene/RViewFrustum.h"
 #include "../Scene/RHorizonGround.h"
 #include "Trackball.h"
@@ -13,6 +14,7 @@
 #include <glm/glm.hpp>
 
 #include "../Scene/Trajectory.h" 
+#include "../GpuProfiler.h"
 
 // [sW] wq GPU øsOc (ŦX OpenGL std430 ƦC)
 struct IndirectDrawCmd {
@@ -29,12 +31,21 @@ struct PlantInstance {
 	glm::vec4 positionAndType;
 };
 
-// [sW] ²檺 Mesh cӺ޲z VAO
+// [ק] Mesh A֦ۤv VAO/VBO/EBOAuOb GeometryPool ̪m
 struct SimpleMesh {
-	GLuint vao = 0;
-	GLuint vbo = 0;
-	GLuint ebo = 0;
+	INANOA::OPENGL::GeometryHandle geometry; // firstIndex / baseVertex i IndirectDrawCmd
 	unsigned int indexCount = 0;
+	// ]y (mesh local space)Gxyz = AABB , w = b|
+	glm::vec4 boundingSphere = glm::vec4(0.0f);
+};
+
+// Y᪺I (16 bytesA쥻 {vec3 p, vec3 n, vec2 t} O 32 bytes)AGeometryPool ̩Ҧ mesh γoӮ榡
+//  foliage_vert.glsl / slime_vert.glsl H gl_VertexID q SSBO Ū (vertex pulling)AgL VAO attribute
+struct PackedVertex {
+	unsigned int posXY;     // half2 (p.x, p.y)
+	unsigned int posZ;      // half2 (p.z, 0)
+	unsigned int normalOct; // snorm16x2 octahedral normal
+	unsigned int uv;        // half2 (u, v)A half ӫD unorm16A~Od REPEAT Ϊ [0,1] H~y
 };
 
 namespace INANOA {
@@ -58,6 +69,9 @@ namespace INANOA {
 		void onGodViewPan(float x, float y);
 		void onGodViewZoom(float delta);
 
+		// C pass  GPU ɶ (main.cpp  Information )
+		GpuProfiler& gpuProfiler() { return m_gpuProfiler; }
+
 	private:
 		SCENE::RViewFrustum* m_viewFrustum = nullptr;
 		SCENE::EXPERIMENTAL::HorizonGround* m_horizontalGround = nullptr;
@@ -120,6 +134,7 @@ namespace INANOA {
 		SimpleMesh m_meshSlime;
 		GLuint m_texSlime = 0;
 		GLuint m_programSlime = 0;
+		GLuint m_slimeIndirect = 0; // u@ command  indirect bufferAvܩi] MDI
 
 		// vܩiy񪫥 (Oob cpp ̪l)
 		SCENE::EXPERIMENTAL::Trajectory m_slimeTrajectory;
@@ -134,17 +149,14 @@ namespace INANOA {
 		void renderSlime(Camera* cam, const glm::vec3& pos);
 		GLuint loadTexture2D(const std::string& filename);
 
-		// @ӦX֫MΪ VAO/VBO/EBOA MultiDraw 
-		GLuint m_foliageVAO = 0;
-		GLuint m_foliageVBO = 0;
-		GLuint m_foliageEBO = 0;
+		// Ҧ mesh @Ϊj VBO/EBO (free-list t)AloadOBJ giӡA MultiDraw 
+		// I buffer sO PackedVertexAH SSBO j POOL_VERTEX_BINDINGFpool  VAO ua EBO
+		OPENGL::GeometryPool* m_geometryPool = nullptr;
+		static const GLuint POOL_VERTEX_BINDING = 5;
 
-		// C@شӪbuX֫vj EBO  index _lm & baseVertex
-		GLuint m_firstIndex[3] = { 0,0,0 };
-		GLuint m_baseVertex[3] = { 0,0,0 };
+		void releaseMesh(SimpleMesh& mesh);
 
-		// إߦX VAO  helper
-		bool buildFoliageMultiDrawVAO();
+		GpuProfiler m_gpuProfiler;
 
 		GLint m_locFoliageView = -1;
 		GLint m_locFoliageProj = -1;
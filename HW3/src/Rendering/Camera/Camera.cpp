@@ -130,6 +130,23 @@ namespace INANOA {
 		}
 	}
 
+	void Camera::viewFrustumPlanesInWorldSpace(glm::vec4* planes) const {
+		// Gribb-Hartmann: the planes are sums/differences of the rows of the view-projection matrix
+		const glm::mat4 vpT = glm::transpose(this->m_projMat * this->m_viewMat);
+
+		planes[0] = vpT[3] + vpT[0];	// left
+		planes[1] = vpT[3] - vpT[0];	// right
+		planes[2] = vpT[3] + vpT[1];	// bottom
+		planes[3] = vpT[3] - vpT[1];	// top
+		planes[4] = vpT[3] + vpT[2];	// near
+		planes[5] = vpT[3] - vpT[2];	// far
+
+		for (int i = 0; i < 6; i++) {
+			const float len = glm::length(glm::vec3(planes[i].x, planes[i].y, planes[i].z));
+			planes[i] = planes[i] / len;
+		}
+	}
+
 
 }
 
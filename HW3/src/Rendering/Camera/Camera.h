@@ -84,6 +84,9 @@ namespace INANOA {
 	public:
 		// return the view space corners
 		void viewFrustumClipPlaneCornersInViewSpace(const float depth, float* corners) const;
+		// return the 6 normalized frustum planes (left, right, bottom, top, near, far) in world space.
+		// plane.xyz is the inward normal, so a point p is inside when dot(plane.xyz, p) + plane.w >= 0
+		void viewFrustumPlanesInWorldSpace(glm::vec4* planes) const;
 
 	private:
 		glm::vec3 m_viewOrg;
@@ -0,0 +1,160 @@
+#include "GeometryPool.h"
+
+#include <algorithm>
+
+namespace INANOA {
+	namespace OPENGL {
+		RangeAllocator::RangeAllocator(const GLuint capacity) : m_capacity(capacity) {
+			this->m_freeRanges.push_back({ 0u, capacity });
+		}
+
+		bool RangeAllocator::allocate(const GLuint count, GLuint& offset) {
+			for (size_t i = 0; i < this->m_freeRanges.size(); i++) {
+				Range& r = this->m_freeRanges[i];
+				if (r.count < count) {
+					continue;
+				}
+				offset = r.offset;
+				r.offset = r.offset + count;
+				r.count = r.count - count;
+				if (r.count == 0) {
+					this->m_freeRanges.erase(this->m_freeRanges.begin() + i);
+				}
+				this->m_used = this->m_used + count;
+				return true;
+			}
+			return false;
+		}
+
+		void RangeAllocator::release(const GLuint offset, const GLuint count) {
+			// keep the list sorted by offset so that neighbours can be merged
+			auto it = std::lower_bound(this->m_freeRanges.begin(), this->m_freeRanges.end(), offset,
+				[](const Range& r, const GLuint o) { return r.offset < o; });
+			it = this->m_freeRanges.insert(it, { offset, count });
+			this->m_used = this->m_used - count;
+
+			// merge with next
+			auto next = it + 1;
+			if (next != this->m_freeRanges.end() && it->offset + it->count == next->offset) {
+				it->count = it->count + next->count;
+				this->m_freeRanges.erase(next);
+			}
+			// merge with previous
+			if (it != this->m_freeRanges.begin()) {
+				auto prev = it - 1;
+				if (prev->offset + prev->count == it->offset) {
+					prev->count = prev->count + it->count;
+					this->m_freeRanges.erase(it);
+				}
+			}
+		}
+
+		void RangeAllocator::grow(const GLuint newCapacity) {
+			if (newCapacity <= this->m_capacity) {
+				return;
+			}
+			const GLuint oldCapacity = this->m_capacity;
+			this->m_capacity = newCapacity;
+			// the new tail is free space, release() merges it with a free range at the old end
+			this->m_used = this->m_used + (newCapacity - oldCapacity);
+			this->release(oldCapacity, newCapacity - oldCapacity);
+		}
+
+		// ========================================================
+		GeometryPool::GeometryPool(const GLuint vertexStride, const GLuint vertexCapacity, const GLuint indexCapacity) :
+			m_vertexStride(vertexStride), m_vertexRanges(vertexCapacity), m_indexRanges(indexCapacity) {}
+
+		GeometryPool::~GeometryPool() {
+			glDeleteVertexArrays(1, &this->m_vaoHandle);
+			glDeleteBuffers(1, &this->m_vertexBufferHandle);
+			glDeleteBuffers(1, &this->m_indexBufferHandle);
+		}
+
+		bool GeometryPool::init() {
+			glGenBuffers(1, &this->m_vertexBufferHandle);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->m_vertexBufferHandle);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)this->m_vertexRanges.capacity() * this->m_vertexStride, nullptr, GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+
+			glGenVertexArrays(1, &this->m_vaoHandle);
+			glBindVertexArray(this->m_vaoHandle);
+			glGenBuffers(1, &this->m_indexBufferHandle);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->m_indexBufferHandle);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)this->m_indexRanges.capacity() * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+			glBindVertexArray(0u);
+
+			return this->m_vertexBufferHandle != 0u && this->m_indexBufferHandle != 0u && this->m_vaoHandle != 0u;
+		}
+
+		GLuint GeometryPool::growBuffer(const GLuint oldBuffer, const GLsizeiptr oldSize, const GLsizeiptr newSize) {
+			GLuint newBuffer = 0u;
+			glGenBuffers(1, &newBuffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_DYNAMIC_DRAW);
+			// GPU-side copy, no readback
+			glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0u);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+			glDeleteBuffers(1, &oldBuffer);
+			return newBuffer;
+		}
+
+		GeometryHandle GeometryPool::allocate(const void* vertices, const GLuint vertexCount, const GLuint* indices, const GLuint indexCount) {
+			GeometryHandle handle;
+			if (vertexCount == 0 || indexCount == 0) {
+				return handle;
+			}
+
+			// vertex range
+			GLuint vertexOffset = 0u;
+			if (this->m_vertexRanges.allocate(vertexCount, vertexOffset) == false) {
+				const GLuint oldCapacity = this->m_vertexRanges.capacity();
+				const GLuint newCapacity = std::max(oldCapacity * 2, oldCapacity + vertexCount);
+				this->m_vertexBufferHandle = GeometryPool::growBuffer(this->m_vertexBufferHandle,
+					(GLsizeiptr)oldCapacity * this->m_vertexStride, (GLsizeiptr)newCapacity * this->m_vertexStride);
+				this->m_vertexRanges.grow(newCapacity);
+				this->m_vertexRanges.allocate(vertexCount, vertexOffset);
+			}
+
+			// index range
+			GLuint indexOffset = 0u;
+			if (this->m_indexRanges.allocate(indexCount, indexOffset) == false) {
+				const GLuint oldCapacity = this->m_indexRanges.capacity();
+				const GLuint newCapacity = std::max(oldCapacity * 2, oldCapacity + indexCount);
+				this->m_indexBufferHandle = GeometryPool::growBuffer(this->m_indexBufferHandle,
+					(GLsizeiptr)oldCapacity * sizeof(GLuint), (GLsizeiptr)newCapacity * sizeof(GLuint));
+				this->m_indexRanges.grow(newCapacity);
+				this->m_indexRanges.allocate(indexCount, indexOffset);
+
+				// the VAO has to point to the new index buffer
+				glBindVertexArray(this->m_vaoHandle);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->m_indexBufferHandle);
+				glBindVertexArray(0u);
+			}
+
+			// upload
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->m_vertexBufferHandle);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)vertexOffset * this->m_vertexStride, (GLsizeiptr)vertexCount * this->m_vertexStride, vertices);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->m_indexBufferHandle);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)indexOffset * sizeof(GLuint), (GLsizeiptr)indexCount * sizeof(GLuint), indices);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+			// indices stay mesh-relative, baseVertex is applied by the draw command
+			handle.firstIndex = indexOffset;
+			handle.indexCount = indexCount;
+			handle.baseVertex = vertexOffset;
+			handle.vertexCount = vertexCount;
+			return handle;
+		}
+
+		void GeometryPool::release(GeometryHandle& handle) {
+			if (handle.valid() == false) {
+				return;
+			}
+			this->m_vertexRanges.release(handle.baseVertex, handle.vertexCount);
+			this->m_indexRanges.release(handle.firstIndex, handle.indexCount);
+			handle = GeometryHandle();
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+
+namespace INANOA {
+	namespace OPENGL {
+		// a sub-allocation inside the pool, usable directly as the
+		// firstIndex / baseVertex pair of a DrawElementsIndirectCommand
+		struct GeometryHandle {
+			GLuint firstIndex = 0;
+			GLuint indexCount = 0;
+			GLuint baseVertex = 0;
+			GLuint vertexCount = 0;
+
+			inline bool valid() const { return this->indexCount > 0; }
+		};
+
+		// first-fit free list over [0, capacity), adjacent free ranges are merged on release
+		class RangeAllocator
+		{
+		public:
+			explicit RangeAllocator(const GLuint capacity);
+
+		public:
+			bool allocate(const GLuint count, GLuint& offset);
+			void release(const GLuint offset, const GLuint count);
+			void grow(const GLuint newCapacity);
+
+		public:
+			inline GLuint capacity() const { return this->m_capacity; }
+			inline GLuint used() const { return this->m_used; }
+
+		private:
+			struct Range {
+				GLuint offset;
+				GLuint count;
+			};
+			std::vector<Range> m_freeRanges;
+			GLuint m_capacity;
+			GLuint m_used = 0;
+		};
+
+		// One large vertex buffer + index buffer pair shared by every mesh.
+		// Vertices are fetched by the shaders from an SSBO (vertex pulling), so the VAO only holds the index buffer.
+		// Both buffers grow on the GPU (glCopyBufferSubData) when a request does not fit.
+		class GeometryPool
+		{
+		public:
+			explicit GeometryPool(const GLuint vertexStride, const GLuint vertexCapacity, const GLuint indexCapacity);
+			virtual ~GeometryPool();
+
+			GeometryPool(const GeometryPool&) = delete;
+			GeometryPool& operator=(const GeometryPool&) = delete;
+
+		public:
+			bool init();
+			GeometryHandle allocate(const void* vertices, const GLuint vertexCount, const GLuint* indices, const GLuint indexCount);
+			void release(GeometryHandle& handle);
+
+		public:
+			inline GLuint vaoHandle() const { return this->m_vaoHandle; }
+			inline GLuint vertexBufferHandle() const { return this->m_vertexBufferHandle; }
+			inline GLuint indexBufferHandle() const { return this->m_indexBufferHandle; }
+			inline GLuint vertexStride() const { return this->m_vertexStride; }
+			inline GLuint numVertexUsed() const { return this->m_vertexRanges.used(); }
+			inline GLuint numIndexUsed() const { return this->m_indexRanges.used(); }
+
+		private:
+			static GLuint growBuffer(const GLuint oldBuffer, const GLsizeiptr oldSize, const GLsizeiptr newSize);
+
+		private:
+			const GLuint m_vertexStride;
+			RangeAllocator m_vertexRanges;
+			RangeAllocator m_indexRanges;
+
+			GLuint m_vaoHandle = 0u;
+			GLuint m_vertexBufferHandle = 0u;
+			GLuint m_indexBufferHandle = 0u;
+		};
+	}
+}
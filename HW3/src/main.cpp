@@ -7,6 +7,8 @@
 #define GL_SILENCE_DEPRECATION
 #include <GLFW/glfw3.h>
 #include "RenderWidgets/RenderingOrderExp.h"
+#include "CpuTrace.h"
+#include "FrameCapture.h"
 
 // =================================================================
 // [sW] jϥΰįd (NVIDIA & AMD)
@@ -23,6 +25,8 @@ const int INIT_WIDTH = 1344;
 const int INIT_HEIGHT = 756;
 double PROGRAM_FPS = 0.0;
 double FRAME_MS = 0.0;
+// [sW] v (PBO DPBŪ^A|d GPU)
+FrameCapture frameCapture;
 
 // ==========================================
 // [sW] иɤWoTܼƫŧi
@@ -33,6 +37,7 @@ bool isRightMousePressed = false;
 
 bool on_init(int displayWidth, int displayHeight)
 {
+	TRACE_SCOPE("on_init");
 	// Initialize render
 	renderer = new INANOA::RenderingOrderExp();
 	if (renderer->init(displayWidth, displayHeight) == false)
@@ -49,6 +54,7 @@ void on_resize(GLFWwindow* window, int w, int h)
 
 inline void on_display()
 {
+	TRACE_SCOPE("on_display");
 	renderer->update();
 	renderer->render();
 }
@@ -66,6 +72,24 @@ inline void on_gui()
 		ImGui::Begin("Information");
 		ImGui::Text(fpsBuf);
 		ImGui::Text(msBuf);
+		// [sW] U pass  GPU ɶ (timestamp queryA|d CPU)
+		ImGui::Separator();
+		renderer->gpuProfiler().drawImGui();
+
+		// [sW] CPU traceGChrome trace_event JSONA chrome://tracing  Perfetto }
+		ImGui::Separator();
+		bool traceEnabled = CpuTrace::enabled();
+		if (ImGui::Checkbox("CPU trace", &traceEnabled)) {
+			CpuTrace::setEnabled(traceEnabled);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Dump cpu_trace.json")) {
+			CpuTrace::dump("cpu_trace.json");
+		}
+
+		// [sW] vGPNG ǦC Y4MAŪ^ 2~3 V~AvTq쪺 frame time
+		ImGui::Separator();
+		frameCapture.drawImGui();
 		ImGui::End();
 	}
 }
@@ -190,6 +214,8 @@ int main(int, char**)
 	// Main loop
 	while (!glfwWindowShouldClose(window))
 	{
+		TRACE_SCOPE("frame");
+
 		// FPS calculation
 		const double timeStamp = glfwGetTime();
 		const double deltaTime = timeStamp - previousTimeStamp;
@@ -226,11 +252,16 @@ int main(int, char**)
 		glfwGetFramebufferSize(window, &display_w, &display_h);
 		glViewport(0, 0, display_w, display_h);
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		frameCapture.captureFrame(display_w, display_h);
 		glfwSwapBuffers(window);
 	}
 
 	// Cleanup
+	frameCapture.release();
 	on_destroy();
+	if (CpuTrace::enabled()) {
+		CpuTrace::dump("cpu_trace.json");
+	}
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();